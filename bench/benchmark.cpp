@@ -0,0 +1,343 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Benchmark of the stripifier on synthetic meshes.
+//
+// Usage: benchmark [--max-faces N] [--threads N] [--cache-size N] [--stats] [generator ...]
+//
+// Generators are grid, sphere, soup, fan, and nonmanifold; all of
+// them are run by default. Each generator is run for 100 faces, and
+// ten times as many faces up to the maximal number of faces, by
+// default 10M. Build with CMAKE_BUILD_TYPE set to Release for
+// meaningful numbers. Besides the rate of each stage, the seconds
+// spent on each phase of stripify are printed; with --stats, the
+// counters of each run are printed as well. Peak memory is measured
+// per run on Linux only, and shown as zero elsewhere.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+
+#include "trianglestripifier.hpp"
+
+typedef std::vector<boost::uint32_t> Indices;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ Generators
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Add triangle v0, v1, v2 to indices.
+static void add_triangle(Indices & indices, int v0, int v1, int v2)
+{
+	indices.push_back(v0);
+	indices.push_back(v1);
+	indices.push_back(v2);
+}
+
+//! Square grid of quads, split in two triangles each.
+static Indices generate_grid(std::size_t num_faces)
+{
+	int size = std::max(1, int(std::sqrt(num_faces / 2.0)));
+	Indices indices;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int v = y * (size + 1) + x;
+			add_triangle(indices, v, v + 1, v + size + 1);
+			add_triangle(indices, v + size + 1, v + 1, v + size + 2);
+		}
+	}
+	return indices;
+}
+
+//! UV sphere, with triangle fans at the poles.
+static Indices generate_sphere(std::size_t num_faces)
+{
+	int rings = std::max(2, int(std::sqrt(num_faces / 4.0)));
+	int segments = 2 * rings;
+	// vertex 0 is the north pole, then rings - 1 rings of
+	// segments vertices, then the south pole
+	int south = 1 + (rings - 1) * segments;
+	Indices indices;
+	for (int s = 0; s < segments; s++) {
+		int s1 = (s + 1) % segments;
+		add_triangle(indices, 0, 1 + s, 1 + s1);
+		for (int r = 0; r < rings - 2; r++) {
+			int v0 = 1 + r * segments;
+			int v1 = v0 + segments;
+			add_triangle(indices, v0 + s, v1 + s, v1 + s1);
+			add_triangle(indices, v0 + s, v1 + s1, v0 + s1);
+		}
+		int v0 = 1 + (rings - 2) * segments;
+		add_triangle(indices, v0 + s, south, v0 + s1);
+	}
+	return indices;
+}
+
+//! Disjoint triangles, without any shared vertex.
+static Indices generate_soup(std::size_t num_faces)
+{
+	Indices indices;
+	for (std::size_t i = 0; i < num_faces; i++)
+		add_triangle(indices, 3 * i, 3 * i + 1, 3 * i + 2);
+	return indices;
+}
+
+//! A single fan around vertex 0, so vertex 0 has a face for every
+//! face of the mesh.
+static Indices generate_fan(std::size_t num_faces)
+{
+	Indices indices;
+	for (std::size_t i = 0; i < num_faces; i++)
+		add_triangle(indices, 0, i + 1, i + 2);
+	return indices;
+}
+
+//! Sixteen faces around every edge of a strip of quads, half of them
+//! in either direction.
+static Indices generate_nonmanifold(std::size_t num_faces)
+{
+	const int pages = 16;
+	Indices indices;
+	int v = 0;
+	for (std::size_t i = 0; i < num_faces; i += pages) {
+		// edge v, v + 1, shared by all pages
+		for (int page = 0; page < pages; page++) {
+			if (page & 1) {
+				add_triangle(indices, v + 1, v, v + 2 + page);
+			} else {
+				add_triangle(indices, v, v + 1, v + 2 + page);
+			}
+		}
+		v += 2 + pages;
+	}
+	return indices;
+}
+
+//! A named generator.
+struct Generator {
+	const char *name;
+	Indices (*generate)(std::size_t num_faces);
+};
+
+static const Generator GENERATORS[] = {
+	{"grid", generate_grid},
+	{"sphere", generate_sphere},
+	{"soup", generate_soup},
+	{"fan", generate_fan},
+	{"nonmanifold", generate_nonmanifold}
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ Measurement
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef std::chrono::steady_clock Clock;
+
+//! Seconds since start.
+static double get_seconds(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//! Reset the peak resident memory of the process to its current
+//! resident memory, so get_peak_memory measures a single run.
+static void reset_peak_memory()
+{
+#if defined(__linux__)
+	std::FILE *file = std::fopen("/proc/self/clear_refs", "w");
+	if (file) {
+		std::fputs("5", file);
+		std::fclose(file);
+	}
+#endif
+}
+
+//! Peak resident memory of the process since reset_peak_memory, in
+//! megabytes, or zero if not known on this platform.
+static double get_peak_memory()
+{
+	double peak = 0.0;
+#if defined(__linux__)
+	std::FILE *file = std::fopen("/proc/self/status", "r");
+	if (file) {
+		char line[256];
+		unsigned long kilobytes;
+		while (std::fgets(line, sizeof(line), file)) {
+			if (std::sscanf(line, "VmHWM: %lu kB", &kilobytes) == 1) {
+				peak = kilobytes / 1024.0;
+				break;
+			}
+		}
+		std::fclose(file);
+	}
+#endif
+	return peak;
+}
+
+//! Millions of faces per second.
+static double get_rate(std::size_t num_faces, double seconds)
+{
+	return (seconds > 0.0) ? (num_faces / seconds / 1e6) : 0.0;
+}
+
+//! Print the counters of stats per face.
+static void print_stats(const StripifyStats & stats)
+{
+	double num_faces = std::max<std::size_t>(stats.num_faces, 1);
+	std::printf("  rounds %lu, experiments %lu, aborted %lu, "
+	            "traversed %.2f, probes %.2f, skips %.2f per face\n",
+	            (unsigned long)stats.num_rounds,
+	            (unsigned long)stats.num_experiments,
+	            (unsigned long)stats.num_aborted_experiments,
+	            stats.num_traversed_faces / num_faces,
+	            stats.num_adjacency_probes / num_faces,
+	            stats.num_reset_point_skips / num_faces);
+}
+
+//! Run all stages on the mesh, and print one line of results, and
+//! the counters of stats if asked for.
+static void run(const char *name, const Indices & indices,
+                int num_threads, int cache_size, StripifyStats & stats,
+                bool print_counters)
+{
+	std::size_t num_faces = indices.size() / 3;
+	stats.clear();
+	reset_peak_memory();
+	// build mesh (including adjacency)
+	Clock::time_point start = Clock::now();
+	MeshPtr mesh(new Mesh(indices.data(), num_faces, &stats));
+	double build_seconds = get_seconds(start);
+	// find strips (build experiments, and commit the best ones)
+	start = Clock::now();
+	TriangleStripifier stripifier(mesh, num_threads, cache_size);
+	stripifier.stats = &stats;
+	std::list<TriangleStripPtr> strips = stripifier.find_all_strips();
+	double stripify_seconds = get_seconds(start);
+	// extract strips into an index buffer
+	start = Clock::now();
+	Indices strip_indices;
+	BOOST_FOREACH(TriangleStripPtr strip, strips) {
+		std::deque<int> vertices = strip->get_strip();
+		strip_indices.insert(strip_indices.end(), vertices.begin(), vertices.end());
+	}
+	double extract_seconds = get_seconds(start);
+	std::printf("%-12s %10lu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10.1f %10lu %10lu\n",
+	            name, (unsigned long)num_faces,
+	            get_rate(num_faces, build_seconds),
+	            get_rate(num_faces, stripify_seconds),
+	            get_rate(num_faces, extract_seconds),
+	            stats.reset_point_seconds,
+	            stats.experiment_seconds,
+	            stats.commit_seconds,
+	            get_peak_memory(),
+	            (unsigned long)strips.size(),
+	            (unsigned long)strip_indices.size());
+	if (print_counters) print_stats(stats);
+	std::fflush(stdout);
+}
+
+//! Parse numeric argument of option.
+static long parse_number(int argc, char **argv, int & i)
+{
+	if (i + 1 == argc)
+		throw std::runtime_error(std::string("Missing value for ") + argv[i] + ".");
+	return std::atol(argv[++i]);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t max_faces = 10000000;
+	int num_threads = 1;
+	int cache_size = 0;
+	bool print_counters = false;
+	std::vector<const Generator *> generators;
+	try {
+		for (int i = 1; i < argc; i++) {
+			if (std::strcmp(argv[i], "--max-faces") == 0) {
+				max_faces = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--threads") == 0) {
+				num_threads = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--cache-size") == 0) {
+				cache_size = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--stats") == 0) {
+				print_counters = true;
+			} else {
+				const Generator *found = 0;
+				BOOST_FOREACH(const Generator & generator, GENERATORS) {
+					if (std::strcmp(argv[i], generator.name) == 0)
+						found = &generator;
+				}
+				if (!found)
+					throw std::runtime_error(std::string("Unknown generator ") + argv[i] + ".");
+				generators.push_back(found);
+			}
+		}
+	} catch (const std::runtime_error & e) {
+		std::fprintf(stderr, "%s\nUsage: %s [--max-faces N] [--threads N] [--cache-size N] [--stats] [grid|sphere|soup|fan|nonmanifold ...]\n",
+		             e.what(), argv[0]);
+		return 1;
+	}
+	if (generators.empty()) {
+		BOOST_FOREACH(const Generator & generator, GENERATORS) {
+			generators.push_back(&generator);
+		}
+	}
+	std::printf("%-12s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+	            "mesh", "faces", "build", "stripify", "extract",
+	            "reset", "experiment", "commit",
+	            "peak", "strips", "indices");
+	std::printf("%-12s %10s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+	            "", "", "Mfaces/s", "Mfaces/s", "Mfaces/s",
+	            "s", "s", "s", "MB", "", "");
+	StripifyStats stats;
+	BOOST_FOREACH(const Generator * generator, generators) {
+		for (std::size_t num_faces = 100; num_faces <= max_faces; num_faces *= 10) {
+			run(generator->name, generator->generate(num_faces),
+			    num_threads, cache_size, stats, print_counters);
+		}
+	}
+	return 0;
+}
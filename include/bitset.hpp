@@ -0,0 +1,142 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_BITSET_HPP
+#define TRISTRIP_BITSET_HPP
+
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Index of the lowest set bit of a non-zero word.
+inline int count_trailing_zeros(boost::uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return index;
+#else
+	int index = 0;
+	while (!(word & 1)) {
+		word >>= 1;
+		index++;
+	};
+	return index;
+#endif
+}
+
+//! A fixed size set of bits, packed in 64 bit words, with a summary
+//! word for every 64 words, in which a bit is set if its word is not
+//! zero. Finding the next set bit skips empty words, and empty runs
+//! of 64 words, at once, so scanning a sparse set is cheap.
+class BitSet
+{
+public:
+	//! Create set of size bits, all set to value.
+	BitSet(std::size_t size, bool value = false)
+		: num_bits(size),
+		  words(num_words(size), value ? ~boost::uint64_t(0) : 0),
+		  summary(num_words(words.size()), value ? ~boost::uint64_t(0) : 0) {
+		if (value) {
+			// clear bits beyond the end
+			if (size % 64) words.back() &= (boost::uint64_t(1) << (size % 64)) - 1;
+			if (words.size() % 64) summary.back() &= (boost::uint64_t(1) << (words.size() % 64)) - 1;
+		};
+	};
+
+	std::size_t size() const {
+		return num_bits;
+	};
+
+	bool test(std::size_t i) const {
+		return (words[i / 64] >> (i % 64)) & 1;
+	};
+
+	void set(std::size_t i) {
+		words[i / 64] |= boost::uint64_t(1) << (i % 64);
+		summary[i / 4096] |= boost::uint64_t(1) << ((i / 64) % 64);
+	};
+
+	void reset(std::size_t i) {
+		boost::uint64_t & word = words[i / 64];
+		word &= ~(boost::uint64_t(1) << (i % 64));
+		if (!word) summary[i / 4096] &= ~(boost::uint64_t(1) << ((i / 64) % 64));
+	};
+
+	//! Index of the first set bit at or after i, or size() if there
+	//! is none.
+	std::size_t find_next(std::size_t i) const {
+		if (i >= num_bits) return num_bits;
+		// rest of the word of i
+		std::size_t w = i / 64;
+		boost::uint64_t word = words[w] & (~boost::uint64_t(0) << (i % 64));
+		if (word) return 64 * w + count_trailing_zeros(word);
+		// rest of the words in the summary word of w
+		w++;
+		std::size_t s = w / 64;
+		if (s >= summary.size()) return num_bits;
+		boost::uint64_t bits = (w % 64) ? summary[s] & (~boost::uint64_t(0) << (w % 64)) : summary[s];
+		// next non-empty summary word
+		while (!bits) {
+			if (++s == summary.size()) return num_bits;
+			bits = summary[s];
+		};
+		w = 64 * s + count_trailing_zeros(bits);
+		return 64 * w + count_trailing_zeros(words[w]);
+	};
+
+private:
+	static std::size_t num_words(std::size_t size) {
+		return (size + 63) / 64;
+	};
+
+	std::size_t num_bits;
+	//! The bits.
+	std::vector<boost::uint64_t> words;
+	//! For each word, whether it is not zero.
+	std::vector<boost::uint64_t> summary;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_CACHEANALYSIS_HPP
+#define TRISTRIP_CACHEANALYSIS_HPP
+
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "vertexcache.hpp"
+
+//! How the indices of a buffer form triangles.
+enum PrimitiveType {
+	//! Each primitive is a triangle strip.
+	PRIMITIVE_TRIANGLE_STRIP,
+	//! Each primitive is a triangle list, three indices per triangle.
+	PRIMITIVE_TRIANGLE_LIST
+};
+
+//! Options for analyze_cache.
+struct CacheAnalysisOptions {
+	PrimitiveType primitive;
+	//! Vertex cache model.
+	int cache_size;
+	CachePolicy policy;
+	//! Whether strips contain primitive restarts.
+	bool primitive_restart;
+	//! Primitive restart index, cast to the index type.
+	boost::uint32_t restart_index;
+
+	CacheAnalysisOptions()
+		: primitive(PRIMITIVE_TRIANGLE_STRIP), cache_size(16),
+		  policy(CACHE_FIFO), primitive_restart(false),
+		  restart_index(0xFFFFFFFF) {};
+};
+
+//! Result of analyze_cache.
+struct CacheStats {
+	//! Number of indices, including restart indices.
+	std::size_t num_indices;
+	//! Number of triangles drawn, not counting degenerate ones.
+	std::size_t num_triangles;
+	//! Number of degenerate triangles.
+	std::size_t num_degenerates;
+	//! Number of primitive restarts.
+	std::size_t num_restarts;
+	//! Number of distinct vertices.
+	std::size_t num_vertices;
+	//! Number of vertex cache misses, that is, of vertices
+	//! transformed.
+	std::size_t num_misses;
+	//! Average cache miss ratio: misses per triangle. At least 0.5
+	//! for any mesh, and 3 without any reuse.
+	float acmr;
+	//! Average transform to vertex ratio: misses per distinct
+	//! vertex. At least 1, which means no vertex is transformed
+	//! twice.
+	float atvr;
+
+	CacheStats();
+};
+
+//! Replay index buffer through a vertex cache. The buffer holds
+//! primitives back to back, with their number of indices in lengths,
+//! as returned by stripify; a triangle list is one primitive. The
+//! cache is kept between primitives. Available for int,
+//! boost::uint16_t, and boost::uint32_t indices.
+template <typename Index>
+CacheStats analyze_cache(const Index *indices,
+                         const std::vector<std::size_t> & lengths,
+                         const CacheAnalysisOptions & options = CacheAnalysisOptions());
+
+#endif
@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_CLUSTERIZER_HPP
+#define TRISTRIP_CLUSTERIZER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "trianglemesh.hpp"
+#include "tristrip.hpp"
+
+//! Default limits of a cluster, which fit a typical mesh shader
+//! meshlet.
+static const int DEFAULT_CLUSTER_VERTICES = 64;
+static const int DEFAULT_CLUSTER_TRIANGLES = 126;
+
+//! Bounds of a cluster, for culling: an axis aligned box, and a
+//! sphere around its center.
+struct ClusterBounds {
+	float min[3];
+	float max[3];
+	float center[3];
+	float radius;
+};
+
+//! A cluster of faces of a mesh, with its strips.
+struct Cluster {
+	//! Faces of the mesh in the cluster, in the order they were
+	//! added.
+	std::vector<int> faces;
+	//! Distinct vertices of the faces, in order of first use.
+	std::vector<int> vertices;
+	//! Strips of the faces, in the output format of stripify.
+	BatchStrips strips;
+	//! Bounds of the vertices, if their positions are known, or
+	//! all zero.
+	ClusterBounds bounds;
+};
+
+//! Split a locked mesh into clusters of adjacent faces, with at
+//! most max_vertices distinct vertices and max_triangles faces each.
+//! Every face is in exactly one cluster. A cluster is grown breadth
+//! first from its first face, along the adjacency of the mesh,
+//! skipping faces which would exceed the vertex limit; these start
+//! later clusters. Returns the faces of each cluster.
+std::vector<std::vector<int> > find_clusters(const Mesh & mesh,
+        int max_vertices = DEFAULT_CLUSTER_VERTICES,
+        int max_triangles = DEFAULT_CLUSTER_TRIANGLES);
+
+//! Split index buffer of num_triangles triangles into clusters, as
+//! find_clusters does, and stripify each cluster on its own, on
+//! num_threads threads, zero meaning one per hardware thread. If
+//! positions is not null, it holds three floats per vertex, and the
+//! bounds of each cluster are computed. The options apply to every
+//! cluster, except for options.num_threads: each cluster is
+//! stripified on one thread. Degenerate and duplicate triangles are
+//! skipped. Previous contents of clusters are replaced.
+void stripify_clusters(const boost::uint32_t *indices, std::size_t num_triangles,
+                       const float *positions, std::vector<Cluster> & clusters,
+                       int max_vertices = DEFAULT_CLUSTER_VERTICES,
+                       int max_triangles = DEFAULT_CLUSTER_TRIANGLES,
+                       int num_threads = 0,
+                       const StripifyOptions & options = StripifyOptions());
+
+#endif
@@ -0,0 +1,218 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_HASHMAP_HPP
+#define TRISTRIP_HASHMAP_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Scramble the bits of a 64 bit integer, so its low bits can be used
+//! as hash table slot (finalizer of MurmurHash3).
+inline boost::uint64_t hash_mix(boost::uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb93fe53b4e63ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+//! Hash functor for integer keys.
+struct IntegerHash {
+	boost::uint64_t operator()(boost::uint64_t key) const {
+		return hash_mix(key);
+	};
+};
+
+//! A hash map using open addressing with linear probing. Entries are
+//! stored in a single contiguous array, so lookups do not allocate
+//! and touch few cache lines. Only insertion and lookup are
+//! supported, which is all that is needed to build a mesh. Hash must
+//! be a functor mapping a key to a well mixed 64 bit integer.
+template <typename Key, typename Value, typename Hash = IntegerHash>
+class HashMap
+{
+public:
+	//! A slot of the table.
+	struct Entry {
+		Key first;
+		Value second;
+		bool used;
+	};
+
+	//! Iterator over used slots.
+	class const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Entry value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Entry * pointer;
+		typedef const Entry & reference;
+
+		const_iterator() : pos(0), last(0) {};
+		const_iterator(const Entry *_pos, const Entry *_last)
+			: pos(_pos), last(_last) {
+			skip();
+		};
+		const Entry & operator*() const {
+			return *pos;
+		};
+		const Entry * operator->() const {
+			return pos;
+		};
+		const_iterator & operator++() {
+			++pos;
+			skip();
+			return *this;
+		};
+		const_iterator operator++(int) {
+			const_iterator result(*this);
+			++(*this);
+			return result;
+		};
+		bool operator==(const const_iterator & other) const {
+			return pos == other.pos;
+		};
+		bool operator!=(const const_iterator & other) const {
+			return pos != other.pos;
+		};
+	private:
+		void skip() {
+			while ((pos != last) && !pos->used) ++pos;
+		};
+		const Entry *pos, *last;
+	};
+	typedef const_iterator iterator;
+
+	HashMap() : entries(), num_entries(0), mask(0) {};
+
+	//! Number of keys in the map.
+	std::size_t size() const {
+		return num_entries;
+	};
+
+	bool empty() const {
+		return num_entries == 0;
+	};
+
+	const_iterator begin() const {
+		return const_iterator(entries.data(), entries.data() + entries.size());
+	};
+
+	const_iterator end() const {
+		return const_iterator(entries.data() + entries.size(),
+		                      entries.data() + entries.size());
+	};
+
+	//! Find key, or return end() if not present.
+	const_iterator find(const Key & key) const {
+		if (entries.empty())
+			return end();
+		std::size_t slot = Hash()(key) & mask;
+		while (entries[slot].used) {
+			if (entries[slot].first == key)
+				return const_iterator(&entries[slot],
+				                      entries.data() + entries.size());
+			slot = (slot + 1) & mask;
+		};
+		return end();
+	};
+
+	//! Get value of key, inserting a default value if the key is not
+	//! yet present.
+	Value & operator[](const Key & key) {
+		// keep load factor at most one half
+		if (2 * (num_entries + 1) > entries.size())
+			rehash(entries.empty() ? 16 : 2 * entries.size());
+		std::size_t slot = Hash()(key) & mask;
+		while (entries[slot].used) {
+			if (entries[slot].first == key)
+				return entries[slot].second;
+			slot = (slot + 1) & mask;
+		};
+		entries[slot].first = key;
+		entries[slot].second = Value();
+		entries[slot].used = true;
+		num_entries++;
+		return entries[slot].second;
+	};
+
+	//! Make room for the given number of keys, so they can be
+	//! inserted without rehashing.
+	void reserve(std::size_t num_keys) {
+		std::size_t capacity = 16;
+		while (capacity < 2 * num_keys) capacity *= 2;
+		if (capacity > entries.size())
+			rehash(capacity);
+	};
+
+	//! Remove all keys and free memory.
+	void clear() {
+		std::vector<Entry>().swap(entries);
+		num_entries = 0;
+		mask = 0;
+	};
+
+private:
+	//! Move all entries into a table of given capacity, which must
+	//! be a power of two.
+	void rehash(std::size_t capacity) {
+		std::vector<Entry> old_entries(capacity);
+		old_entries.swap(entries);
+		mask = capacity - 1;
+		for (std::size_t i = 0; i < old_entries.size(); i++) {
+			if (!old_entries[i].used)
+				continue;
+			std::size_t slot = Hash()(old_entries[i].first) & mask;
+			while (entries[slot].used) slot = (slot + 1) & mask;
+			entries[slot] = old_entries[i];
+		};
+	};
+
+	std::vector<Entry> entries;
+	std::size_t num_entries;
+	std::size_t mask;
+};
+
+#endif
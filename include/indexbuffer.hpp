@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_INDEXBUFFER_HPP
+#define TRISTRIP_INDEXBUFFER_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "tristrip.hpp"
+
+//! What an index buffer file holds, one for each output of stripify.
+enum IndexBufferContent {
+	//! Triangles, three indices each.
+	CONTENT_TRIANGLES,
+	//! Triangle strips, back to back, with the length of each.
+	CONTENT_STRIPS,
+	//! A single strip, joining strips with degenerate triangles.
+	CONTENT_STITCHED_STRIP,
+	//! A single strip, with strips separated by the restart index.
+	CONTENT_RESTART_STRIP
+};
+
+//! Header of an index buffer file. The header is followed by the
+//! packed indices, and for CONTENT_STRIPS, padded to 8 bytes, by the
+//! length of each strip as 64 bit integer. Everything is in native
+//! byte order.
+struct IndexBufferHeader {
+	//! INDEX_BUFFER_MAGIC.
+	char magic[8];
+	//! INDEX_BUFFER_VERSION.
+	boost::uint32_t version;
+	//! Bytes per index, 2 or 4.
+	boost::uint32_t index_size;
+	//! An IndexBufferContent.
+	boost::uint32_t content;
+	//! Restart index, for CONTENT_RESTART_STRIP.
+	boost::uint32_t restart_index;
+	//! Number of triangles, not counting degenerate triangles of
+	//! strips.
+	boost::uint64_t num_triangles;
+	boost::uint64_t num_indices;
+	//! Number of strip lengths, for CONTENT_STRIPS, or zero.
+	boost::uint64_t num_strips;
+};
+
+static const char INDEX_BUFFER_MAGIC[8] = {'T', 'R', 'I', 'S', 'T', 'R', 'I', 'P'};
+static const boost::uint32_t INDEX_BUFFER_VERSION = 1;
+
+//! An index buffer file, mapped read only into memory, so indices
+//! can be used straight from the mapped pages. Throws
+//! std::runtime_error if the file cannot be read, or is not a valid
+//! index buffer file.
+class IndexBufferFile
+{
+public:
+	IndexBufferFile(const std::string & filename);
+	~IndexBufferFile();
+
+	const IndexBufferHeader & get_header() const {
+		return *reinterpret_cast<const IndexBufferHeader *>(data);
+	};
+
+	//! The indices, which must be of type Index.
+	template <typename Index>
+	const Index *get_indices() const {
+		if (get_header().index_size != sizeof(Index))
+			throw std::runtime_error("Index size of index buffer file does not match.");
+		return reinterpret_cast<const Index *>(data + sizeof(IndexBufferHeader));
+	};
+
+	//! The strip lengths, for CONTENT_STRIPS.
+	const boost::uint64_t *get_lengths() const;
+
+private:
+	IndexBufferFile(const IndexBufferFile &);
+	IndexBufferFile & operator=(const IndexBufferFile &);
+
+	const char *data;
+	std::size_t size;
+	//! Contents of the file, where it cannot be mapped.
+	std::vector<char> buffer;
+};
+
+//! Write num_indices indices, of index_size bytes each, to an index
+//! buffer file. For CONTENT_STRIPS, lengths has the length of each
+//! strip. Throws std::runtime_error on failure.
+void write_index_buffer(const std::string & filename, IndexBufferContent content,
+                        int index_size, const void *indices, std::size_t num_indices,
+                        const std::vector<std::size_t> & lengths,
+                        boost::uint32_t restart_index = 0xFFFFFFFF);
+
+//! Stripify the triangles of an index buffer file, straight from the
+//! mapped file, and write the result to another index buffer file,
+//! with the same index size. The content of the result follows
+//! options.output.
+void stripify_file(const std::string & input_filename, const std::string & output_filename,
+                   const StripifyOptions & options = StripifyOptions());
+
+#endif
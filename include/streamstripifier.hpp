@@ -0,0 +1,140 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_STREAMSTRIPIFIER_HPP
+#define TRISTRIP_STREAMSTRIPIFIER_HPP
+
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "tristrip.hpp"
+
+//! Stripifies a mesh which is given as a stream of triangles, and
+//! writes the strips to an output stream, without ever holding the
+//! whole mesh in memory. Triangles are cut into chunks of consecutive
+//! triangles, which are stripified one by one, so the input should
+//! be ordered for locality, as scanned and tessellated meshes
+//! usually are.
+//!
+//! Every chunk is only stripified once the triangles of the next
+//! chunk are known. Strips with an edge shared with the next chunk
+//! are not written yet: their faces are carried over into the next
+//! chunk, so strips can grow across the border. At most half a chunk
+//! is carried over, the other strips along the border are cut there.
+//! Duplicate triangles are only removed within a chunk.
+//!
+//! The output consists of native 32 bit indices. For OUTPUT_STRIPS,
+//! each strip is written as its length followed by its indices. For
+//! the other outputs, only the indices are written: a single strip
+//! for OUTPUT_STITCHED_STRIP and OUTPUT_RESTART_STRIP, and a triangle
+//! list, optimized chunk by chunk, for OUTPUT_TRIANGLE_LIST.
+class StreamStripifier
+{
+public:
+	//! Estimated memory used per triangle of a chunk: the indices,
+	//! the mesh with all its temporary arrays, the stripifier, and
+	//! the strips.
+	static const std::size_t BYTES_PER_TRIANGLE = 384;
+
+	//! Smallest number of triangles in a chunk, whatever the budget.
+	static const std::size_t MIN_CHUNK_TRIANGLES = 1024;
+
+	//! Maximal number of triangles in a chunk, derived from the
+	//! memory budget.
+	const std::size_t max_chunk_triangles;
+
+	//! Number of triangles added, chunks stripified, and strips and
+	//! indices written so far.
+	std::size_t num_triangles;
+	std::size_t num_chunks;
+	std::size_t num_strips;
+	std::size_t num_indices;
+
+	//! Write strips to output. Chunks are sized so that stripifying
+	//! them takes about memory_budget bytes.
+	StreamStripifier(std::ostream & _output, std::size_t memory_budget,
+	                 const StripifyOptions & _options = StripifyOptions());
+
+	//! Add triangles, three indices each. Stripifies and writes
+	//! chunks as soon as they are complete.
+	void add_triangles(const boost::uint32_t *indices, std::size_t num_triangles);
+
+	//! Stripify and write all remaining triangles.
+	void finish();
+
+private:
+	//! Stripify chunk, and write all its strips, except those
+	//! sharing an edge with next, which are carried over into
+	//! carried.
+	void stripify_chunk();
+
+	//! Write strip, with its stitch or restart indices.
+	void write_strip(const std::deque<int> & strip);
+
+	//! Write indices.
+	void write(const boost::uint32_t *indices, std::size_t size);
+
+	std::ostream & output;
+	StripifyOptions options;
+
+	//! Triangles of the chunk: carried over triangles first, then
+	//! new triangles.
+	std::vector<boost::uint32_t> chunk;
+
+	//! Triangles of the next chunk, read ahead.
+	std::vector<boost::uint32_t> next;
+
+	//! Triangles carried over from chunk into the next chunk.
+	std::vector<boost::uint32_t> carried;
+
+	//! Last index written, for stitching.
+	boost::uint32_t last_index;
+};
+
+//! Stripify triangles read from input, as native 32 bit indices, and
+//! write the strips to output, using at most about memory_budget
+//! bytes. See StreamStripifier for the output format.
+void stripify_stream(std::istream & input, std::ostream & output,
+                     std::size_t memory_budget,
+                     const StripifyOptions & options = StripifyOptions());
+
+#endif
@@ -0,0 +1,117 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_STRIPIFYSTATS_HPP
+#define TRISTRIP_STRIPIFYSTATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+//! Counters and wall times of a stripification, to find out why a
+//! mesh is slow. Filled in by the Mesh constructor and by
+//! TriangleStripifier::find_all_strips, if given one; without it,
+//! nothing is counted or timed. Everything is added to, so a single
+//! StripifyStats can sum up several calls, but it must not be shared
+//! by calls running at the same time.
+struct StripifyStats {
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~ Mesh
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	//! Triangles of the index buffer.
+	std::size_t num_triangles;
+	//! Triangles skipped because they are degenerate, or because
+	//! they duplicate an earlier triangle.
+	std::size_t num_degenerate_triangles;
+	std::size_t num_duplicate_triangles;
+	//! Faces of the mesh that remain.
+	std::size_t num_faces;
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~ Stripifier
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	//! Rounds of experiments, each of which commits the strips of
+	//! one experiment.
+	std::size_t num_rounds;
+	//! Experiments built, and those of them which were aborted as
+	//! they could no longer beat the best experiment.
+	std::size_t num_experiments;
+	std::size_t num_aborted_experiments;
+	//! Faces added to the strips of experiments by traverse_faces.
+	std::size_t num_traversed_faces;
+	//! Adjacent faces looked at by get_unmarked_adjacent_face.
+	std::size_t num_adjacency_probes;
+	//! Reset points found by find_good_reset_point, and the number
+	//! of faces skipped in total to find a free one.
+	std::size_t num_reset_points;
+	std::size_t num_reset_point_skips;
+	//! Number of committed strips with each number of faces.
+	std::vector<std::size_t> strip_length_histogram;
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~ Wall time, in seconds
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	//! Removing degenerate and duplicate triangles.
+	double face_seconds;
+	//! Building the adjacency arrays.
+	double adjacency_seconds;
+	//! Finding reset points, and the seeds of experiments.
+	double reset_point_seconds;
+	//! Building experiments.
+	double experiment_seconds;
+	//! Selecting the best experiment, and committing its strips.
+	double commit_seconds;
+
+	StripifyStats();
+
+	//! Set everything back to zero.
+	void clear();
+
+	//! Add the counters and times of other stats, for instance of
+	//! another thread.
+	void add(const StripifyStats & stats);
+
+	//! Count committed strip with given number of faces.
+	void add_strip(std::size_t num_strip_faces);
+
+	//! Number of committed strips.
+	std::size_t get_num_strips() const;
+};
+
+#endif
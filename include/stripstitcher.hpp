@@ -0,0 +1,66 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_STRIPSTITCHER_HPP
+#define TRISTRIP_STRIPSTITCHER_HPP
+
+#include <deque>
+#include <vector>
+
+//! Join strips into a single strip, with degenerate triangles between
+//! them. All strips must be in forward winding, as returned by
+//! TriangleStrip::get_strip, and the result has forward winding too.
+//!
+//! Strips are reordered greedily: the next strip is one with an end
+//! equal to the end of the strip so far, if any, so the join takes
+//! only one or two extra indices; otherwise, it is the next strip in
+//! the original order, joined with two or three extra indices. To
+//! keep the parity of each strip right with the fewest extra indices,
+//! strips are reversed where that does not change their winding: any
+//! strip of even length, or a strip of odd length that starts at an
+//! odd position.
+std::deque<int> stitch_strips(const std::vector<std::deque<int> > & strips);
+
+//! Degenerate indices to append to a stitched strip of given size,
+//! ending with last_vertex, before appending strip as it is, so that
+//! strip keeps its winding. This is how strips are joined when they
+//! cannot be reordered, for instance when the stitched strip is
+//! written out piece by piece.
+std::vector<int> get_stitch_indices(std::size_t size, int last_vertex,
+                                    const std::deque<int> & strip);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_THREADPOOL_HPP
+#define TRISTRIP_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! A fixed set of worker threads for running a number of independent
+//! tasks in parallel. The thread calling run takes part in the work,
+//! so a pool of size one runs everything on the calling thread.
+//!
+//! Tasks are scheduled by work stealing: they are dealt round robin
+//! to a queue per worker, each worker takes tasks from the front of
+//! its own queue, and once that is empty, steals tasks from the back
+//! of the other queues. So if tasks are ordered from large to small,
+//! every worker starts on a large task, and the small ones fill the
+//! gaps at the end.
+class ThreadPool
+{
+public:
+	//! A task gets its own index, and the index of the worker
+	//! running it, which is less than the size of the pool and can
+	//! be used to address per thread storage.
+	typedef std::function<void (int task, int worker)> Task;
+
+	//! Create pool with given number of threads, including the
+	//! calling thread. Zero means one per hardware thread.
+	ThreadPool(int num_threads);
+
+	//! Stops and joins all worker threads.
+	~ThreadPool();
+
+	//! Number of threads, including the calling thread.
+	int size() const;
+
+	//! Run task for all indices from 0 up to num_tasks, and return
+	//! when all are done. If any task throws, the first exception is
+	//! rethrown here, once all running tasks have finished.
+	void run(int num_tasks, const Task & task);
+
+private:
+	//! Tasks of a worker, in tasks[front] up to tasks[back].
+	struct WorkQueue {
+		std::mutex mutex;
+		std::vector<int> tasks;
+		std::size_t front, back;
+	};
+
+	//! Main loop of a worker thread.
+	void work(int worker);
+
+	//! Run tasks of the current job until none are left.
+	void run_tasks(int worker);
+
+	//! Take task from the front of the queue of worker. Returns
+	//! false if the queue is empty.
+	bool pop_task(int worker, int & task);
+
+	//! Take task from the back of the queue of another
+	//! worker. Returns false if all queues are empty.
+	bool steal_task(int worker, int & task);
+
+	int num_workers;
+	std::unique_ptr<WorkQueue[]> queues;
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable job_started;
+	std::condition_variable job_finished;
+	//! Incremented for every job, so workers can detect new jobs.
+	int job_id;
+	const Task *job_task;
+	//! Number of workers still running tasks of the current job.
+	int num_busy;
+	std::exception_ptr error;
+	//! Set when a task failed, so no further tasks are started.
+	std::atomic<bool> failed;
+	bool stopping;
+};
+
+#endif
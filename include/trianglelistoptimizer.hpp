@@ -0,0 +1,76 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_TRIANGLELISTOPTIMIZER_HPP
+#define TRISTRIP_TRIANGLELISTOPTIMIZER_HPP
+
+#include <vector>
+
+#include "trianglemesh.hpp"
+
+//! Reorders the faces of a mesh for post transform vertex cache
+//! locality, to draw them as an indexed triangle list. This is the
+//! greedy algorithm of Tom Forsyth, "Linear-Speed Vertex Cache
+//! Optimisation": each vertex gets a score from its position in a
+//! simulated least recently used cache and from the number of faces
+//! still using it, and the face with the highest total score among
+//! the faces of the cached vertices is drawn next.
+class TriangleListOptimizer
+{
+public:
+	//! Cache size used if none is given.
+	static const int DEFAULT_CACHE_SIZE = 32;
+
+	//! The mesh whose faces are reordered.
+	MeshPtr mesh;
+
+	//! Size of the simulated vertex cache.
+	int cache_size;
+
+	//! Cache sizes below four are raised to four, as the last face
+	//! takes three entries.
+	TriangleListOptimizer(MeshPtr _mesh, int _cache_size = DEFAULT_CACHE_SIZE);
+
+	//! Score of a vertex at given position in the cache (-1 if it
+	//! is not in the cache), used by num_faces faces not yet drawn.
+	float get_vertex_score(int cache_pos, int num_faces) const;
+
+	//! Indices of all faces of the mesh, in drawing order.
+	std::vector<int> find_face_order();
+};
+
+#endif
@@ -58,28 +58,26 @@ POSSIBILITY OF SUCH DAMAGE.
 //~
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#ifndef TRISTRIP_TRIANGLEMESH_HPP
+#define TRISTRIP_TRIANGLEMESH_HPP
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //~ Imports
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/weak_ptr.hpp>
-#include <map>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "hashmap.hpp"
+#include "stripifystats.hpp"
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //~ Definitions
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-// forward declarations
-
-class MEdge;
-typedef boost::shared_ptr<MEdge> MEdgePtr;
-
-class MFace;
-typedef boost::shared_ptr<MFace> MFacePtr;
-
 //! A standalone non-degenerate directed edge, represented as a pair
 //! of indices.
 class Edge
@@ -91,21 +89,11 @@ public:
 
 	bool operator<(const Edge & otheredge) const;
 	bool operator==(const Edge & otheredge) const;
-};
-
-//! A non-degenerate directed edge with links to other parts of a
-//! mesh.
-class MEdge : public Edge
-{
-public:
-	typedef std::vector<boost::weak_ptr<MFace> > Faces;
-	Faces faces; //! Note: faces are set in Mesh::add_face.
-
-	//! Note: don't call directly! Use Mesh::add_face.
-	MEdge(const Edge & edge);
 
-	//! Dump to std::cout (e.g. for debugging).
-	void dump() const;
+	//! Both indices packed into a single 64 bit integer.
+	boost::uint64_t key() const {
+		return (boost::uint64_t(boost::uint32_t(ev0)) << 32) | boost::uint32_t(ev1);
+	};
 };
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -119,6 +107,10 @@ public:
 
 	Face(int _v0, int _v1, int _v2);
 
+	//! Face with all indices zero. Note: this is not a valid face,
+	//! it only serves to initialize empty slots in hash maps.
+	Face();
+
 	bool operator<(const Face & otherface) const;
 	bool operator==(const Face & otherface) const;
 
@@ -126,78 +118,131 @@ public:
 	int get_next_vertex(int vi) const;
 };
 
-//! A non-degenerate face with links to other parts of a mesh.
-class MFace : public Face
-{
-public:
-	typedef std::vector<boost::weak_ptr<MFace> > Faces;
-	//! Adjacent faces along edge opposite vertex v0, v1, and v2.
-	Faces faces0, faces1, faces2;
-
-	//! The id of the strip the face is assigned to in final
-	//! stripification.
-	int strip_id;
-
-	//! The id of the strip the face is assigned to during a
-	//! stripification experiment.
-	int test_strip_id;
-
-	//! The id of the stripification experiment.
-	int experiment_id;
+//! Hash functor for faces.
+struct FaceHash {
+	boost::uint64_t operator()(const Face & face) const {
+		return hash_mix(Edge(face.v0, face.v1).key()
+		                ^ (boost::uint64_t(face.v2) * 0x9e3779b97f4a7c15ULL));
+	};
+};
 
-	//! Note: don't call directly! Use Mesh::add_face.
-	MFace(const Face & face);
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-	//! Get list of adjacent faces along edge opposite vertex vi.
-	Faces & get_adjacent_faces(int vi);
+//! A contiguous range of face indices, pointing into the adjacency
+//! array of a mesh.
+class FaceRange
+{
+public:
+	typedef const int * const_iterator;
+	typedef const_iterator iterator;
+
+	FaceRange(const_iterator _first, const_iterator _last);
+
+	const_iterator begin() const {
+		return first;
+	};
+	const_iterator end() const {
+		return last;
+	};
+	std::size_t size() const {
+		return last - first;
+	};
+	bool empty() const {
+		return first == last;
+	};
+	int operator[](std::size_t i) const {
+		return first[i];
+	};
 
-	//! Dump to std::cout (e.g. for debugging).
-	void dump() const;
+private:
+	const_iterator first, last;
 };
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-//! A mesh built from faces.
+//! A mesh built from faces. Faces are identified by their index in
+//! the faces vector. Adjacency between faces, and the marks used
+//! during stripification, are stored in flat arrays indexed by face.
 class Mesh
 {
 private:
-	//! Create new edge for mesh for given face, or return
-	//! existing edge. Lists of faces of the new/existing edge is
-	//! also updated, as well as lists of adjacent faces. For
-	//! internal use only, called on each edge of the face in
-	//! add_face.
-	void add_edge(MFacePtr face, int pv0, int pv1);
+	//! Register the j-th edge of face as occurrence of the directed
+	//! edge (pv0, pv1). For internal use only, called on each edge
+	//! of the face in add_face.
+	void add_edge(int face, int j, int pv0, int pv1);
+
+	//! Whether the mesh has been locked.
+	bool locked;
 
 public:
-	// We use maps to avoid duplicate entries and quickly detect
-	// adjacent faces.
+	// We use hash maps to avoid duplicate entries and quickly
+	// detect adjacent faces.
 
-	typedef std::map<Face, boost::weak_ptr<MFace> > FaceMap;
-	typedef std::map<Edge, MEdgePtr> EdgeMap;
+	typedef HashMap<Face, int, FaceHash> FaceMap;
+	typedef HashMap<boost::uint64_t, std::pair<int, int> > EdgeMap;
 
 	//! Map for mesh faces. Used internally to avoid
 	//! duplicates. Deleted when mesh is locked.
 	FaceMap _faces;
 
-	//! Map for mesh edges. Used internally to build lists of
-	//! adjacent faces. Deleted when mesh is locked.
+	//! Map for mesh edges, keyed by Edge::key. Maps each edge to
+	//! its first and last occurrence in _edge_next. Used internally
+	//! to build the adjacency arrays. Deleted when mesh is locked.
 	EdgeMap _edges;
 
+	//! For the j-th edge of each face f, at index 3 * f + j, the
+	//! next occurrence of the same directed edge in a later face, or
+	//! -1. Deleted when mesh is locked.
+	std::vector<int> _edge_next;
+
 	//! Vector containing all faces.
-	std::vector<MFacePtr> faces;
+	std::vector<Face> faces;
+
+	//! Adjacency offsets, three per face plus one terminator. The
+	//! faces adjacent to face f along the edge opposite its k-th
+	//! vertex (k = 0, 1, 2 for v0, v1, v2) are stored in
+	//! adjacency[adjacency_offsets[3 * f + k]] up to
+	//! adjacency[adjacency_offsets[3 * f + k + 1]]. Set by lock.
+	std::vector<int> adjacency_offsets;
+
+	//! Indices of adjacent faces. Set by lock.
+	std::vector<int> adjacency;
 
 	//! Initialize empty mesh.
 	Mesh();
 
-	//! Create new face for mesh, or return existing face.
-	MFacePtr add_face(int v0, int v1, int v2);
-
-	//! Lock the mesh. Frees memory by clearing the _edges and _faces
-	//! maps which are only used to update the face adjacency lists.
+	//! Build a locked mesh from an index buffer, with three
+	//! indices per triangle. Degenerate and duplicate triangles are
+	//! skipped. The result is identical to adding all triangles in
+	//! order with add_face, and locking the mesh, but it is built
+	//! with a few sorting passes rather than a lookup per edge.
+	//! Available for int, boost::uint16_t, and boost::uint32_t
+	//! indices. If stats is given, the skipped triangles and the
+	//! time of each pass are added to it.
+	template <typename Index>
+	Mesh(const Index *indices, std::size_t num_triangles, StripifyStats *stats = 0);
+
+	//! Create new face for mesh, or return existing face. Returns
+	//! the index of the face.
+	int add_face(int v0, int v1, int v2);
+
+	//! Reserve memory for the given number of faces, so they can be
+	//! added without reallocating.
+	void reserve(int num_faces);
+
+	//! Lock the mesh. Builds the adjacency arrays, and frees memory
+	//! by clearing the _edges and _faces maps. No faces can be added
+	//! to a locked mesh, so it can be shared between threads.
 	void lock();
 
+	//! Get range of adjacent faces along edge opposite vertex vi
+	//! of the given face. Mesh must be locked.
+	FaceRange get_adjacent_faces(int face, int vi) const;
+
 	//! Dump to std::cout (e.g. for debugging).
 	void dump() const;
 };
 
 typedef boost::shared_ptr<Mesh> MeshPtr;
+
+#endif
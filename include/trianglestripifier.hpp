@@ -50,13 +50,107 @@ POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#ifndef TRISTRIP_TRIANGLESTRIPIFIER_HPP
+#define TRISTRIP_TRIANGLESTRIPIFIER_HPP
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <deque>
+#include <functional>
 #include <list>
-#include <set>
+#include <memory>
+#include <memory_resource>
 #include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
 
+#include "bitset.hpp"
+#include "stripifystats.hpp"
+#include "threadpool.hpp"
 #include "trianglemesh.hpp"
+#include "twoendedbuffer.hpp"
+#include "vertexcache.hpp"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Marks of faces which are tentatively assigned to strips during
+//! stripification experiments. Experiments which run concurrently
+//! must use separate marks. Marks of earlier experiments need not be
+//! cleared, as experiment ids are unique.
+class ExperimentMarks
+{
+public:
+	//! For each face, the id of the experiment which it was last
+	//! assigned to, or -1.
+	std::vector<int> experiment_id;
+
+	ExperimentMarks(int num_faces);
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! All state of a single stripification of a mesh: the marks of the
+//! faces, the counters for strip and experiment ids, the vertex
+//! cache after the committed strips, and the memory resource for the
+//! committed strips. Nothing is shared between
+//! contexts, so separate stripifications can run concurrently, even
+//! on the same mesh.
+class StripifierContext
+{
+public:
+	//! The mesh, which must be locked.
+	const Mesh & mesh;
+
+	//! For each face, the id of the strip the face is assigned
+	//! to in final stripification, or -1.
+	std::vector<int> strip_id;
+
+	//! Marks for experiments, one for each experiment that can be
+	//! built concurrently.
+	std::vector<ExperimentMarks> marks;
+
+	//! Number of strips committed. Used to determine next strip id.
+	int num_strips;
+
+	//! Number of experiments declared. Used to determine next
+	//! experiment id.
+	int num_experiments;
+
+	//! Number of faces which are not in any committed strip yet.
+	int num_free_faces;
+
+	//! Bit for each face which is not in any committed strip yet,
+	//! so free faces can be found without scanning strip_id.
+	BitSet free_faces;
+
+	//! Size of the vertex cache to optimize for, or zero to build
+	//! strips as long as possible regardless of the cache.
+	int cache_size;
+
+	//! Maximal number of faces in a strip, or zero for no limit.
+	//! Derived from cache_size, so that a strip still is in the
+	//! cache when a parallel strip is built next to it.
+	int max_strip_faces;
+
+	//! State of the vertex cache after drawing all committed
+	//! strips, in order. Only updated if cache_size is not zero.
+	VertexCache cache;
+
+	//! Memory for committed strips, which outlive the rounds of
+	//! experiments.
+	std::pmr::memory_resource *resource;
+
+	//! Whether strips count their probes of adjacent faces, for
+	//! StripifyStats. Off unless stats are kept.
+	bool count_probes;
+
+	StripifierContext(const Mesh & _mesh, int num_marks = 1, int _cache_size = 0,
+	                  std::pmr::memory_resource *_resource = std::pmr::get_default_resource());
+
+	//! Assign face to strip, or to no strip if id is -1, keeping
+	//! free_faces up to date.
+	void set_strip_id(int face, int id);
+};
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -66,13 +160,22 @@ public:
 	//Heavily adapted from NvTriStrip.
 	//Original can be found at http://developer.nvidia.com/view.asp?IO=nvtristrip_library.
 
-	// List of faces (implementation note: this is a deque and not
-	// a vector because we need push_front).
-	std::deque<MFacePtr> faces;
+	//! The stripification which the strip is part of.
+	StripifierContext & context;
+
+	//! The mesh whose faces are stripified.
+	const Mesh & mesh;
+
+	//! The marks of the experiment.
+	ExperimentMarks & marks;
+
+	// List of face indices (implementation note: this is a two
+	// ended buffer and not a vector because we need push_front).
+	TwoEndedBuffer<int> faces;
 
 	//! Identical to faces, but written as a strip (whose winding
 	//! determined by reversed).
-	std::deque<int> vertices;
+	TwoEndedBuffer<int> vertices;
 
 	//! Winding of strip: false means that strip can be used as
 	//! such, true means that winding is reversed. Winding can be
@@ -85,54 +188,110 @@ public:
 	//! part of an experiment until commit is called.
 	int experiment_id;
 
-	//! Identifier of the strip.
+	//! Identifier of the strip. Assigned on commit, -1 before.
 	int strip_id;
 
-	//! Number of strips declared. Used to determine next strip id.
-	static int NUM_STRIPS; // Initialized to zero in cpp file.
+	//! Number of adjacent faces looked at while building the strip,
+	//! for StripifyStats. Only counted if context.count_probes is set.
+	std::size_t num_probes;
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~ Public Methods
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-	TriangleStrip(int _experiment_id);
+	//! The faces and vertices are allocated from resource.
+	TriangleStrip(StripifierContext & _context, ExperimentMarks & _marks, int _experiment_id,
+	              std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+	//! Copy of strip, with its faces and vertices allocated from
+	//! resource.
+	TriangleStrip(const TriangleStrip & strip, std::pmr::memory_resource *resource);
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~ Element Membership Tests
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 	//! Is the face marked in this strip?
-	bool is_face_marked(MFacePtr face);
+	bool is_face_marked(int face);
 
 	//! Mark face in this strip.
-	void mark_face(MFacePtr face);
+	void mark_face(int face);
 
-	//! Get unmarked adjacent face.
-	MFacePtr get_unmarked_adjacent_face(MFacePtr face, int vi);
+	//! Get unmarked adjacent face, or -1 if there is none.
+	int get_unmarked_adjacent_face(int face, int vi);
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 
 	//! Building face traversal list starting from the start_face and
 	//! the edge opposite start_vertex. Returns number of faces added.
-	int traverse_faces(int start_vertex, MFacePtr start_face,
+	int traverse_faces(int start_vertex, int start_face,
 	                   bool forward);
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 	//! Builds the face strip forwards, then backwards. Returns
 	//! index of start_face.
-	int build(int start_vertex, MFacePtr start_face);
+	int build(int start_vertex, int start_face);
 
-	//! Tag strip, and its faces, as non-experimental.
+	//! Tag strip, and its faces, as non-experimental. In cache aware
+	//! mode, also feeds the strip through the cache of the context.
 	void commit();
 
 	//! Get strip (always in forward winding).
 	std::deque<int> get_strip();
+
+	//! Number of indices of the strip returned by get_strip.
+	std::size_t get_strip_size() const;
+
+	//! Write strip, as returned by get_strip, to out, and return the
+	//! end of the written range. This is a single (reverse) copy.
+	template <typename OutputIterator>
+	OutputIterator copy_strip(OutputIterator out) const;
+
+	//! Get strip in forward winding, as one or two strips, without
+	//! degenerate faces. Where get_strip would add a duplicate
+	//! vertex to change winding, the first face is split off as a
+	//! separate strip instead.
+	std::list<std::deque<int> > get_split_strip();
 };
 
+template <typename OutputIterator>
+OutputIterator TriangleStrip::copy_strip(OutputIterator out) const
+{
+	if (reversed) {
+		if (vertices.size() & 1) {
+			// odd length: change winding by reversing
+			return std::reverse_copy(vertices.begin(), vertices.end(), out);
+		} else if (vertices.size() == 4) {
+			// length 4: we can change winding without
+			// appending a vertex
+			*out++ = vertices[0];
+			*out++ = vertices[2];
+			*out++ = vertices[1];
+			*out++ = vertices[3];
+			return out;
+		} else {
+			// all other cases: append duplicate vertex to
+			// front
+			*out++ = vertices.front();
+		};
+	};
+	return std::copy(vertices.begin(), vertices.end(), out);
+}
+
 typedef boost::shared_ptr<TriangleStrip> TriangleStripPtr;
 
+//! Create object of type T, with its control block, from a memory
+//! resource. With a monotonic resource, freeing is a no-op, so all
+//! objects must be gone before the resource is released.
+template <typename T, typename... Args>
+boost::shared_ptr<T> allocate_shared(std::pmr::memory_resource *resource, Args && ... args)
+{
+	return boost::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource),
+	                                 std::forward<Args>(args)...);
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //~ Experiment
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -142,23 +301,56 @@ typedef boost::shared_ptr<TriangleStrip> TriangleStripPtr;
 class Experiment
 {
 public:
-	std::list<TriangleStripPtr> strips;
+	//! Called after every strip that is added while building;
+	//! building stops as soon as it returns false.
+	typedef std::function<bool (const Experiment & experiment)> Predicate;
+
+	StripifierContext & context;
+	//! Memory for the strips.
+	std::pmr::memory_resource *resource;
+	std::pmr::list<TriangleStripPtr> strips;
 	int vertex;
-	MFacePtr face;
+	int face;
 	int experiment_id;
 
-	//! Number of experiments declared. Used to determine next
-	//! experiment id.
-	static int NUM_EXPERIMENTS; // Initialized to zero in cpp file.
+	//! Total number of faces of the strips.
+	int num_faces;
+
+	//! Number of vertex cache misses when drawing the strips
+	//! right after the committed strips, and the state of the
+	//! cache after drawing them. Only updated in cache aware mode.
+	int num_misses;
+	VertexCache cache;
 
-	Experiment(int _vertex, MFacePtr _face);
+	//! Whether building was stopped before all strips were built.
+	bool aborted;
 
-	//! Build strips, starting from vertex and face.
-	void build();
+	//! Takes the next experiment id from the context. Strips and
+	//! the copy of the cache are allocated from the resource.
+	Experiment(StripifierContext & _context, int _vertex, int _face,
+	           std::pmr::memory_resource *_resource = std::pmr::get_default_resource());
+
+	//! Experiment with given id, which must not be used by any other
+	//! experiment of the context.
+	Experiment(StripifierContext & _context, int _vertex, int _face, int _experiment_id,
+	           std::pmr::memory_resource *_resource = std::pmr::get_default_resource());
+
+	//! Build strips, starting from vertex and face, marking faces
+	//! in the given marks. If keep_building is set, building is
+	//! aborted once it returns false.
+	void build(ExperimentMarks & marks, const Predicate & keep_building = Predicate());
 
 	//! Build strips adjacent to given strip, and add them to the
 	//! experiment. This is a helper function used by build.
 	bool build_adjacent(TriangleStripPtr strip, int face_index);
+
+private:
+	//! Add built strip, and update the counts. Returns false if
+	//! building must stop.
+	bool add_strip(TriangleStripPtr strip);
+
+	//! The predicate of the current build, or 0.
+	const Predicate *keep_building;
 };
 
 typedef boost::shared_ptr<Experiment> ExperimentPtr;
@@ -187,9 +379,22 @@ public:
 	ExperimentSelector(int _num_samples, int _min_strip_length);
 
 	//! Updates best experiment with given experiment, if given
-	//! experiment beats current experiment.
+	//! experiment beats current experiment. Aborted experiments
+	//! are skipped.
 	void update_score(ExperimentPtr experiment);
 
+	//! Score of a fully built experiment. The score is the average
+	//! number of faces per strip. In cache aware mode, it is the
+	//! number of faces per vertex cache miss instead, counting every
+	//! strip as one extra miss for its restart.
+	float get_score(const Experiment & experiment) const;
+
+	//! Upper bound for the score of a partially built experiment,
+	//! however its remaining strips turn out: at best, all free
+	//! faces end up in as few strips as possible, without any
+	//! cache misses.
+	float get_max_score(const Experiment & experiment) const;
+
 	//! Remove best experiment, to start a fresh sequence of
 	//! experiments.
 	void clear();
@@ -210,13 +415,48 @@ public:
 
 	ExperimentSelector selector;
 	MeshPtr mesh;
-	std::vector<MFacePtr>::const_iterator start_face_iter;
+	int start_face;
+
+	//! Threads for building the experiments of each round.
+	ThreadPool pool;
+
+	//! Marks and ids of the stripification, with experiment marks
+	//! for each thread of the pool.
+	StripifierContext context;
+
+	//! Memory for the experiments of a round, one arena for each
+	//! thread of the pool, released after every round.
+	std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource> > arenas;
+
+	//! Initial buffers of the arenas, so rounds of typical size need
+	//! no allocations at all.
+	std::vector<std::vector<char> > arena_buffers;
+
+	//! Number of rounds of experiments started.
+	int num_rounds;
+
+	//! For each face, the last round in which it was picked as
+	//! reset point, or -1. A face is only picked once per round.
+	std::vector<int> reset_point_round;
+
+	//! Where find_all_strips adds its counters and times, or null
+	//! to skip all bookkeeping.
+	StripifyStats *stats;
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~ Public Methods
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-	TriangleStripifier(MeshPtr _mesh);
+	//! Locks the mesh, if it is not yet locked. Experiments are
+	//! built on the given number of threads; zero means one per
+	//! hardware thread. The result does not depend on the number of
+	//! threads. If cache_size is not zero, strips are optimized for
+	//! a vertex cache of that size: they are kept short enough to
+	//! stay in the cache, and experiments are selected for cache
+	//! hits. The returned strips are allocated from resource, which
+	//! also backs the arenas for experiments.
+	TriangleStripifier(MeshPtr _mesh, int num_threads = 1, int cache_size = 0,
+	                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~ Protected Methods
@@ -224,8 +464,8 @@ public:
 
 	//! Find a good face to start stripification, potentially
 	//! after some strips have already been created. Result is
-	//! stored in start_face_iter. Will store mesh->faces.end()
-	//! when no more faces are left.
+	//! stored in start_face. Returns false when no more faces
+	//! are left.
 	bool find_good_reset_point();
 
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -233,3 +473,5 @@ public:
 	//! Find all strips.
 	std::list<TriangleStripPtr> find_all_strips();
 };
+
+#endif
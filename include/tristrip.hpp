@@ -35,9 +35,143 @@ POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#ifndef TRISTRIP_TRISTRIP_HPP
+#define TRISTRIP_TRISTRIP_HPP
+
+#include <cstddef>
 #include <list>
 #include <deque>
+#include <memory_resource>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "stripifystats.hpp"
+#include "trianglemesh.hpp"
+
+//! What stripify produces.
+enum StripifyOutput {
+	//! Triangle strips.
+	OUTPUT_STRIPS,
+	//! A single triangle strip, joining all strips with degenerate
+	//! triangles.
+	OUTPUT_STITCHED_STRIP,
+	//! A single index buffer, with the strips separated by the
+	//! primitive restart index, and without degenerate triangles.
+	OUTPUT_RESTART_STRIP,
+	//! A single indexed triangle list, with three indices per
+	//! triangle, ordered for vertex cache locality.
+	OUTPUT_TRIANGLE_LIST
+};
+
+//! Options for stripify.
+struct StripifyOptions {
+	//! Whether to produce strips, one stitched strip, a strip with
+	//! primitive restarts, or a triangle list.
+	StripifyOutput output;
+	//! Primitive restart index for OUTPUT_RESTART_STRIP, cast to
+	//! the index type, so the default gives 0xFFFF for 16 bit
+	//! indices, and 0xFFFFFFFF for 32 bit indices. No vertex may
+	//! have this index.
+	boost::uint32_t restart_index;
+	//! Number of threads for building experiments, zero meaning one
+	//! per hardware thread. The strips do not depend on it.
+	int num_threads;
+	//! Size of the post transform vertex cache to optimize for, or
+	//! zero to build strips as long as possible. Triangle lists are
+	//! always optimized for the cache, for a size of 32 if zero.
+	int cache_size;
+	//! Memory for the stripifier, or null for the default resource.
+	//! Used concurrently by stripify_batch, by a single call with
+	//! num_threads other than one, as the arena of each thread
+	//! allocates from it, and by concurrent calls with the same
+	//! resource, so it must be thread safe there.
+	std::pmr::memory_resource *resource;
+	//! Number of start faces sampled for each round of experiments,
+	//! each giving three experiments. More samples give better
+	//! strips, at a higher cost.
+	int num_samples;
+	//! Where to add counters and times of mesh building and
+	//! stripification, or null to skip all bookkeeping. Functions
+	//! which stripify on several threads gather separate stats per
+	//! thread, and add them up here at the end.
+	StripifyStats *stats;
+
+	StripifyOptions()
+		: output(OUTPUT_STRIPS), restart_index(0xFFFFFFFF),
+		  num_threads(1), cache_size(0), resource(0), num_samples(10),
+		  stats(0) {};
+};
+
+// The stripify functions keep no global state, so they can be called
+// from several threads at once, on the same or on different meshes.
+
+//! Stripify list of triangles. A stitched strip, a strip with
+//! restarts, or a triangle list is returned as a single element.
+std::list<std::deque<int> > stripify(const std::list<std::list<int> > & triangles,
+                                     const StripifyOptions & options = StripifyOptions());
+
+//! Stripify index buffer of num_triangles triangles, with three
+//! indices per triangle. The indices of all strips are written
+//! consecutively to strip_indices, and the length of each strip to
+//! strip_lengths; previous contents of both are replaced. A stitched
+//! strip, a strip with restarts, or a triangle list is returned as a
+//! single strip.
+void stripify(const boost::uint16_t *indices, std::size_t num_triangles,
+              std::vector<boost::uint16_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options = StripifyOptions());
+
+//! Stripify index buffer of num_triangles triangles, with three
+//! indices per triangle. The indices of all strips are written
+//! consecutively to strip_indices, and the length of each strip to
+//! strip_lengths; previous contents of both are replaced. A stitched
+//! strip, a strip with restarts, or a triangle list is returned as a
+//! single strip.
+void stripify(const boost::uint32_t *indices, std::size_t num_triangles,
+              std::vector<boost::uint32_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options = StripifyOptions());
+
+//! Stripify a mesh which has already been built, for instance to
+//! time building it separately. Otherwise identical to stripify on
+//! the index buffer of the mesh.
+void stripify(MeshPtr mesh,
+              std::vector<boost::uint32_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options = StripifyOptions());
+
+//! A mesh to stripify with stripify_batch: an index buffer of
+//! num_triangles triangles, with three indices per triangle.
+struct BatchMesh {
+	const boost::uint32_t *indices;
+	std::size_t num_triangles;
+};
+
+//! Strips of a mesh, as returned by stripify_batch: the indices of
+//! all strips back to back, and the length of each strip.
+struct BatchStrips {
+	std::vector<boost::uint32_t> indices;
+	std::vector<std::size_t> lengths;
+};
 
-//! Stripify list of triangles.
-std::list<std::deque<int> > stripify(const std::list<std::list<int> > & triangles);
+//! Stripify many meshes on num_threads threads, zero meaning one per
+//! hardware thread. The strips of each mesh are stored in strips, in
+//! the same order as meshes; each is identical to the result of
+//! stripify on that mesh alone. Large meshes are started first, and
+//! small meshes are grouped, to keep all threads busy. If
+//! max_triangles is not zero, meshes with more triangles are cut
+//! into parts of at most max_triangles consecutive triangles, which
+//! are stripified independently; this gives more parallelism, but
+//! strips do not cross parts, and duplicate triangles are only
+//! removed within a part. A stitched strip, a strip with restarts,
+//! or a triangle list is still returned as a single strip per mesh,
+//! joining the parts in order. The options apply to every mesh,
+//! except for options.num_threads: each mesh is stripified on one
+//! thread.
+void stripify_batch(const std::vector<BatchMesh> & meshes,
+                    std::vector<BatchStrips> & strips,
+                    int num_threads = 0, std::size_t max_triangles = 0,
+                    const StripifyOptions & options = StripifyOptions());
 
+#endif
@@ -0,0 +1,207 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_TWOENDEDBUFFER_HPP
+#define TRISTRIP_TWOENDEDBUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+
+//! A contiguous sequence that grows at both ends, for trivially
+//! copyable elements. Elements are kept in the middle of a single
+//! array, with room in front and at the back, so push_front is as
+//! cheap as push_back, and the contents can be copied out in one go.
+//! Memory comes from a std::pmr::memory_resource.
+template <typename T>
+class TwoEndedBuffer
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+	              "TwoEndedBuffer needs trivially copyable elements.");
+
+public:
+	typedef T value_type;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef T & reference;
+	typedef const T & const_reference;
+	typedef T * iterator;
+	typedef const T * const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	//! Empty buffer, allocating from resource.
+	explicit TwoEndedBuffer(std::pmr::memory_resource *_resource = std::pmr::get_default_resource())
+		: resource(_resource), buffer(0), capacity(0), first(0), last(0) {};
+
+	//! Copy of other, allocating from the default resource, as
+	//! std::pmr containers do.
+	TwoEndedBuffer(const TwoEndedBuffer & other)
+		: resource(std::pmr::get_default_resource()), buffer(0), capacity(0), first(0), last(0) {
+		assign(other);
+	};
+
+	//! Copy of other, allocating from resource.
+	TwoEndedBuffer(const TwoEndedBuffer & other, std::pmr::memory_resource *_resource)
+		: resource(_resource), buffer(0), capacity(0), first(0), last(0) {
+		assign(other);
+	};
+
+	~TwoEndedBuffer() {
+		deallocate();
+	};
+
+	TwoEndedBuffer & operator=(const TwoEndedBuffer & other) {
+		if (this != &other) assign(other);
+		return *this;
+	};
+
+	size_type size() const {
+		return last - first;
+	};
+	bool empty() const {
+		return first == last;
+	};
+
+	iterator begin() {
+		return buffer + first;
+	};
+	iterator end() {
+		return buffer + last;
+	};
+	const_iterator begin() const {
+		return buffer + first;
+	};
+	const_iterator end() const {
+		return buffer + last;
+	};
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	};
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	};
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	};
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	};
+
+	reference operator[](size_type i) {
+		return buffer[first + i];
+	};
+	const_reference operator[](size_type i) const {
+		return buffer[first + i];
+	};
+	reference front() {
+		return buffer[first];
+	};
+	const_reference front() const {
+		return buffer[first];
+	};
+	reference back() {
+		return buffer[last - 1];
+	};
+	const_reference back() const {
+		return buffer[last - 1];
+	};
+
+	void push_back(const T & value) {
+		if (last == capacity) grow();
+		buffer[last++] = value;
+	};
+	void push_front(const T & value) {
+		if (first == 0) grow();
+		buffer[--first] = value;
+	};
+	void pop_back() {
+		last--;
+	};
+	void pop_front() {
+		first++;
+	};
+
+	//! Remove all elements, keeping the memory, with equal room at
+	//! both ends.
+	void clear() {
+		first = last = capacity / 2;
+	};
+
+private:
+	//! Replace contents by those of other.
+	void assign(const TwoEndedBuffer & other) {
+		if (other.size() > capacity) {
+			deallocate();
+			capacity = other.size();
+			buffer = static_cast<T *>(resource->allocate(capacity * sizeof(T), alignof(T)));
+		}
+		first = (capacity - other.size()) / 2;
+		last = first + other.size();
+		if (!other.empty())
+			std::memcpy(buffer + first, other.buffer + other.first, other.size() * sizeof(T));
+	};
+
+	//! Double the capacity, and center the elements.
+	void grow() {
+		size_type new_capacity = (capacity < 8) ? 16 : 2 * capacity;
+		T *new_buffer = static_cast<T *>(resource->allocate(new_capacity * sizeof(T), alignof(T)));
+		size_type new_first = (new_capacity - size()) / 2;
+		if (!empty())
+			std::memcpy(new_buffer + new_first, buffer + first, size() * sizeof(T));
+		last = new_first + size();
+		first = new_first;
+		deallocate();
+		buffer = new_buffer;
+		capacity = new_capacity;
+	};
+
+	void deallocate() {
+		if (buffer) resource->deallocate(buffer, capacity * sizeof(T), alignof(T));
+		buffer = 0;
+	};
+
+	std::pmr::memory_resource *resource;
+	T *buffer;
+	size_type capacity;
+	//! Elements are in buffer[first] up to buffer[last].
+	size_type first, last;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TRISTRIP_VERTEXCACHE_HPP
+#define TRISTRIP_VERTEXCACHE_HPP
+
+#include <memory_resource>
+#include <vector>
+
+//! Replacement policy of a vertex cache.
+enum CachePolicy {
+	//! First in first out: a hit does not change the order in
+	//! which vertices are evicted. This is what most GPUs do.
+	CACHE_FIFO,
+	//! Least recently used: a hit makes the vertex the last one to
+	//! be evicted.
+	CACHE_LRU
+};
+
+//! Simulation of a post transform vertex cache.
+class VertexCache
+{
+public:
+	//! Create empty cache holding up to size vertices, allocated
+	//! from resource.
+	VertexCache(int size, CachePolicy _policy = CACHE_FIFO,
+	            std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+	//! Copy of cache, allocated from resource.
+	VertexCache(const VertexCache & cache, std::pmr::memory_resource *resource);
+
+	VertexCache(const VertexCache & cache) = default;
+
+	//! Replacement policy.
+	CachePolicy policy;
+
+	//! Number of vertices the cache can hold.
+	int size() const;
+
+	//! Is the vertex in the cache?
+	bool contains(int vertex) const;
+
+	//! Process vertex. Returns true on a cache hit. On a miss, the
+	//! vertex is added, evicting the first vertex in line if the
+	//! cache is full, and false is returned.
+	bool add(int vertex);
+
+	//! Remove all vertices.
+	void clear();
+
+private:
+	//! Position of vertex in entries, or -1.
+	int find(int vertex) const;
+
+	//! Ring buffer of vertices, next in line for eviction at index
+	//! next once full.
+	std::pmr::vector<int> entries;
+	int next;
+	int num_entries;
+};
+
+#endif
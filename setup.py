@@ -9,12 +9,11 @@ Topic :: Multimedia :: Graphics :: 3D Modeling
 Programming Language :: C++
 Programming Language :: Cython
 Programming Language :: Python
-Programming Language :: Python :: 2
 Programming Language :: Python :: 3
+Programming Language :: Python :: 3 :: Only
 Operating System :: OS Independent"""
 
-from distutils.core import setup
-from distutils.extension import Extension
+from setuptools import setup, Extension
 from Cython.Distutils import build_ext
 
 readme = open("README.rst").read().split("\n")
@@ -26,15 +25,37 @@ setup(
         Extension(
             "tristrip",
             ["tristrip.pyx",
+             "src/cacheanalysis.cpp",
+             "src/clusterizer.cpp",
+             "src/indexbuffer.cpp",
+             "src/streamstripifier.cpp",
+             "src/stripifystats.cpp",
+             "src/stripstitcher.cpp",
+             "src/threadpool.cpp",
+             "src/trianglelistoptimizer.cpp",
              "src/trianglemesh.cpp",
              "src/trianglestripifier.cpp",
-             "src/tristrip.cpp"],
+             "src/tristrip.cpp",
+             "src/vertexcache.cpp"],
             language="c++",
+            extra_compile_args=["-std=c++17"],
             include_dirs=["include"],
             depends=[
+                 "include/bitset.hpp",
+                 "include/cacheanalysis.hpp",
+                 "include/clusterizer.hpp",
+                 "include/hashmap.hpp",
+                 "include/indexbuffer.hpp",
+                 "include/streamstripifier.hpp",
+                 "include/stripifystats.hpp",
+                 "include/stripstitcher.hpp",
+                 "include/threadpool.hpp",
+                 "include/trianglelistoptimizer.hpp",
                  "include/trianglemesh.hpp",
                  "include/trianglestripifier.hpp",
-                 "include/tristrip.hpp"],
+                 "include/tristrip.hpp",
+                 "include/twoendedbuffer.hpp",
+                 "include/vertexcache.hpp"],
             )
         ],
     author="Amorilia",
@@ -43,9 +64,11 @@ setup(
     keywords="stripify",
     platforms="any",
     description=readme[0],
-    classifiers=filter(None, classifiers.split("\n")),
+    classifiers=[line for line in classifiers.split("\n") if line],
     long_description="\n".join(readme[2:]),
     url="http://github.com/amorilia/tristrip",
     download_url="http://github.com/amorilia/tristrip/downloads",
+    python_requires=">=3.3",
+    install_requires=["numpy"],
     cmdclass={'build_ext': build_ext},
 )
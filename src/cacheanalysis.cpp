@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::sort std::unique
+#include <stdexcept>
+
+#include <boost/foreach.hpp>
+
+#include "cacheanalysis.hpp"
+
+CacheStats::CacheStats()
+	: num_indices(0), num_triangles(0), num_degenerates(0),
+	  num_restarts(0), num_vertices(0), num_misses(0),
+	  acmr(0.0), atvr(0.0) {};
+
+//! Count triangle v0, v1, v2.
+static void add_triangle(int v0, int v1, int v2, CacheStats & stats)
+{
+	if ((v0 == v1) || (v1 == v2) || (v2 == v0)) {
+		stats.num_degenerates++;
+	} else {
+		stats.num_triangles++;
+	}
+}
+
+template <typename Index>
+CacheStats analyze_cache(const Index *indices,
+                         const std::vector<std::size_t> & lengths,
+                         const CacheAnalysisOptions & options)
+{
+	CacheStats stats;
+	VertexCache cache(options.cache_size, options.policy);
+	std::vector<int> vertices;
+	int restart_index = Index(options.restart_index);
+	bool restart = options.primitive_restart
+	               && (options.primitive == PRIMITIVE_TRIANGLE_STRIP);
+	BOOST_FOREACH(std::size_t length, lengths) {
+		// number of indices in the current strip or list
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < length; i++) {
+			int vertex = indices[i];
+			stats.num_indices++;
+			if (restart && (vertex == restart_index)) {
+				stats.num_restarts++;
+				count = 0;
+				continue;
+			}
+			if (!cache.add(vertex)) stats.num_misses++;
+			vertices.push_back(vertex);
+			count++;
+			if (options.primitive == PRIMITIVE_TRIANGLE_STRIP) {
+				if (count >= 3)
+					add_triangle(indices[i - 2], indices[i - 1], vertex, stats);
+			} else {
+				if (count % 3 == 0)
+					add_triangle(indices[i - 2], indices[i - 1], vertex, stats);
+			}
+		}
+		if ((options.primitive == PRIMITIVE_TRIANGLE_LIST) && (count % 3))
+			throw std::runtime_error("Triangle list length is not a multiple of three.");
+		indices += length;
+	}
+	std::sort(vertices.begin(), vertices.end());
+	stats.num_vertices = std::unique(vertices.begin(), vertices.end()) - vertices.begin();
+	if (stats.num_triangles)
+		stats.acmr = float(stats.num_misses) / stats.num_triangles;
+	if (stats.num_vertices)
+		stats.atvr = float(stats.num_misses) / stats.num_vertices;
+	return stats;
+}
+
+template CacheStats analyze_cache<int>(const int *, const std::vector<std::size_t> &, const CacheAnalysisOptions &);
+template CacheStats analyze_cache<boost::uint16_t>(const boost::uint16_t *, const std::vector<std::size_t> &, const CacheAnalysisOptions &);
+template CacheStats analyze_cache<boost::uint32_t>(const boost::uint32_t *, const std::vector<std::size_t> &, const CacheAnalysisOptions &);
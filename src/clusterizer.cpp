@@ -0,0 +1,170 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::find std::min std::max
+#include <cmath> // std::sqrt
+#include <stdexcept>
+
+#include <boost/foreach.hpp>
+
+#include "bitset.hpp"
+#include "clusterizer.hpp"
+#include "threadpool.hpp"
+
+//! Number of clusters stripified by a single task of the pool.
+static const std::size_t CLUSTERS_PER_TASK = 32;
+
+std::vector<std::vector<int> > find_clusters(const Mesh & mesh, int max_vertices, int max_triangles)
+{
+	if ((max_vertices < 3) || (max_triangles < 1))
+		throw std::runtime_error("Cluster must fit at least one triangle.");
+	std::vector<std::vector<int> > clusters;
+	int num_faces = mesh.faces.size();
+	BitSet free_faces(num_faces, true);
+	// for each face, the last cluster it was queued for, or -1
+	std::vector<int> queued(num_faces, -1);
+	std::vector<int> queue;
+	std::vector<int> vertices;
+	for (int start = free_faces.find_next(0); start < num_faces;
+	     start = free_faces.find_next(start)) {
+		int cluster = clusters.size();
+		clusters.push_back(std::vector<int>());
+		std::vector<int> & faces = clusters.back();
+		vertices.clear();
+		queue.assign(1, start);
+		queued[start] = cluster;
+		for (std::size_t head = 0;
+		     (head < queue.size()) && (int(faces.size()) < max_triangles); head++) {
+			int face = queue[head];
+			const Face & f = mesh.faces[face];
+			int face_vertices[] = {f.v0, f.v1, f.v2};
+			int num_new_vertices = 0;
+			BOOST_FOREACH(int vertex, face_vertices) {
+				if (std::find(vertices.begin(), vertices.end(), vertex) == vertices.end())
+					num_new_vertices++;
+			};
+			if (int(vertices.size()) + num_new_vertices > max_vertices) continue;
+			// add face, and queue its free neighbours
+			free_faces.reset(face);
+			faces.push_back(face);
+			BOOST_FOREACH(int vertex, face_vertices) {
+				if (std::find(vertices.begin(), vertices.end(), vertex) == vertices.end())
+					vertices.push_back(vertex);
+				BOOST_FOREACH(int otherface, mesh.get_adjacent_faces(face, vertex)) {
+					if (free_faces.test(otherface) && (queued[otherface] != cluster)) {
+						queued[otherface] = cluster;
+						queue.push_back(otherface);
+					};
+				};
+			};
+		};
+	};
+	return clusters;
+}
+
+//! Bounds of the given vertices.
+static ClusterBounds get_bounds(const std::vector<int> & vertices, const float *positions)
+{
+	ClusterBounds bounds = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0};
+	if (!positions || vertices.empty()) return bounds;
+	for (int i = 0; i < 3; i++) {
+		bounds.min[i] = bounds.max[i] = positions[3 * vertices[0] + i];
+	};
+	BOOST_FOREACH(int vertex, vertices) {
+		for (int i = 0; i < 3; i++) {
+			bounds.min[i] = std::min(bounds.min[i], positions[3 * vertex + i]);
+			bounds.max[i] = std::max(bounds.max[i], positions[3 * vertex + i]);
+		};
+	};
+	for (int i = 0; i < 3; i++) {
+		bounds.center[i] = 0.5f * (bounds.min[i] + bounds.max[i]);
+	};
+	float radius2 = 0;
+	BOOST_FOREACH(int vertex, vertices) {
+		float d2 = 0;
+		for (int i = 0; i < 3; i++) {
+			float d = positions[3 * vertex + i] - bounds.center[i];
+			d2 += d * d;
+		};
+		radius2 = std::max(radius2, d2);
+	};
+	bounds.radius = std::sqrt(radius2);
+	return bounds;
+}
+
+void stripify_clusters(const boost::uint32_t *indices, std::size_t num_triangles,
+                       const float *positions, std::vector<Cluster> & clusters,
+                       int max_vertices, int max_triangles, int num_threads,
+                       const StripifyOptions & options)
+{
+	Mesh mesh(indices, num_triangles, options.stats);
+	std::vector<std::vector<int> > cluster_faces = find_clusters(mesh, max_vertices, max_triangles);
+	clusters.clear();
+	clusters.resize(cluster_faces.size());
+	// stripify all clusters, each on a single thread, with stats
+	// for each thread
+	StripifyOptions cluster_options(options);
+	cluster_options.num_threads = 1;
+	ThreadPool pool(num_threads);
+	std::vector<StripifyStats> worker_stats(options.stats ? pool.size() : 0);
+	std::size_t num_tasks = (clusters.size() + CLUSTERS_PER_TASK - 1) / CLUSTERS_PER_TASK;
+	pool.run(num_tasks, [&](int task, int worker) {
+		StripifyOptions worker_options(cluster_options);
+		if (options.stats) worker_options.stats = &worker_stats[worker];
+		std::vector<boost::uint32_t> cluster_indices;
+		std::size_t last = std::min(clusters.size(), (task + 1) * CLUSTERS_PER_TASK);
+		for (std::size_t i = task * CLUSTERS_PER_TASK; i < last; i++) {
+			Cluster & cluster = clusters[i];
+			cluster.faces.swap(cluster_faces[i]);
+			cluster_indices.clear();
+			BOOST_FOREACH(int face, cluster.faces) {
+				const Face & f = mesh.faces[face];
+				int face_vertices[] = {f.v0, f.v1, f.v2};
+				BOOST_FOREACH(int vertex, face_vertices) {
+					cluster_indices.push_back(vertex);
+					if (std::find(cluster.vertices.begin(), cluster.vertices.end(), vertex)
+					    == cluster.vertices.end())
+						cluster.vertices.push_back(vertex);
+				};
+			};
+			stripify(cluster_indices.data(), cluster.faces.size(),
+			         cluster.strips.indices, cluster.strips.lengths, worker_options);
+			cluster.bounds = get_bounds(cluster.vertices, positions);
+		};
+	});
+	BOOST_FOREACH(const StripifyStats & stats, worker_stats) options.stats->add(stats);
+}
@@ -0,0 +1,252 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <cstring> // std::memcmp std::memcpy
+#include <fstream>
+#include <iterator> // std::istreambuf_iterator
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TRISTRIP_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "indexbuffer.hpp"
+
+//! Offset of the strip lengths in a file with given header.
+static boost::uint64_t get_lengths_offset(const IndexBufferHeader & header)
+{
+	boost::uint64_t offset = sizeof(IndexBufferHeader) + header.num_indices * header.index_size;
+	return (offset + 7) & ~boost::uint64_t(7);
+}
+
+IndexBufferFile::IndexBufferFile(const std::string & filename)
+	: data(0), size(0), buffer()
+{
+#ifdef TRISTRIP_MMAP
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw std::runtime_error("Cannot open " + filename + ".");
+	struct stat st;
+	if (::fstat(fd, &st) == -1) {
+		::close(fd);
+		throw std::runtime_error("Cannot open " + filename + ".");
+	};
+	size = st.st_size;
+	if (size >= sizeof(IndexBufferHeader)) {
+		void *p = ::mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED) {
+			::close(fd);
+			throw std::runtime_error("Cannot map " + filename + ".");
+		};
+		data = static_cast<const char *>(p);
+	};
+	::close(fd);
+#else
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Cannot open " + filename + ".");
+	buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	size = buffer.size();
+	data = buffer.data();
+#endif
+	// check header, and that the file holds all indices and lengths
+	const char *error = 0;
+	if (size < sizeof(IndexBufferHeader)) {
+		error = "Index buffer file too short.";
+	} else {
+		const IndexBufferHeader & header = get_header();
+		boost::uint64_t num_bytes = size - sizeof(IndexBufferHeader);
+		if (std::memcmp(header.magic, INDEX_BUFFER_MAGIC, sizeof(header.magic)) != 0) {
+			error = "Not an index buffer file.";
+		} else if (header.version != INDEX_BUFFER_VERSION) {
+			error = "Unsupported index buffer file version.";
+		} else if ((header.index_size != 2) && (header.index_size != 4)) {
+			error = "Invalid index size in index buffer file.";
+		} else if (header.content > CONTENT_RESTART_STRIP) {
+			error = "Invalid content in index buffer file.";
+		} else if (header.num_indices > num_bytes / header.index_size) {
+			error = "Index buffer file too short.";
+		} else if ((header.content == CONTENT_TRIANGLES)
+		           && ((header.num_indices % 3)
+		               || (header.num_triangles != header.num_indices / 3))) {
+			error = "Invalid number of triangles in index buffer file.";
+		} else if ((header.num_strips > 0)
+		           && ((header.num_strips > num_bytes / 8)
+		               || (get_lengths_offset(header) + 8 * header.num_strips > size))) {
+			error = "Index buffer file too short.";
+		};
+	};
+	if (error) {
+#ifdef TRISTRIP_MMAP
+		if (data) ::munmap(const_cast<char *>(data), size);
+#endif
+		throw std::runtime_error(error);
+	};
+}
+
+IndexBufferFile::~IndexBufferFile()
+{
+#ifdef TRISTRIP_MMAP
+	::munmap(const_cast<char *>(data), size);
+#endif
+}
+
+const boost::uint64_t *IndexBufferFile::get_lengths() const
+{
+	return reinterpret_cast<const boost::uint64_t *>(data + get_lengths_offset(get_header()));
+}
+
+//! Number of non-degenerate triangles of a strip.
+template <typename Index>
+static boost::uint64_t count_strip_triangles(const Index *first, const Index *last)
+{
+	boost::uint64_t num_triangles = 0;
+	for (; last - first >= 3; ++first) {
+		if ((first[0] != first[1]) && (first[1] != first[2]) && (first[2] != first[0]))
+			num_triangles++;
+	};
+	return num_triangles;
+}
+
+//! Number of non-degenerate triangles of indices.
+template <typename Index>
+static boost::uint64_t count_triangles(IndexBufferContent content,
+                                       const Index *indices, std::size_t num_indices,
+                                       const std::vector<std::size_t> & lengths,
+                                       Index restart_index)
+{
+	boost::uint64_t num_triangles = 0;
+	if (content == CONTENT_TRIANGLES) {
+		if (num_indices % 3)
+			throw std::runtime_error("Number of triangle indices must be a multiple of 3.");
+		num_triangles = num_indices / 3;
+	} else if (content == CONTENT_STRIPS) {
+		std::size_t first = 0;
+		for (std::size_t i = 0; i < lengths.size(); i++) {
+			if (lengths[i] > num_indices - first)
+				throw std::runtime_error("Strip lengths exceed number of indices.");
+			num_triangles += count_strip_triangles(indices + first, indices + first + lengths[i]);
+			first += lengths[i];
+		};
+	} else if (content == CONTENT_RESTART_STRIP) {
+		std::size_t first = 0;
+		for (std::size_t i = 0; i <= num_indices; i++) {
+			if ((i == num_indices) || (indices[i] == restart_index)) {
+				num_triangles += count_strip_triangles(indices + first, indices + i);
+				first = i + 1;
+			};
+		};
+	} else {
+		num_triangles = count_strip_triangles(indices, indices + num_indices);
+	};
+	return num_triangles;
+}
+
+void write_index_buffer(const std::string & filename, IndexBufferContent content,
+                        int index_size, const void *indices, std::size_t num_indices,
+                        const std::vector<std::size_t> & lengths,
+                        boost::uint32_t restart_index)
+{
+	IndexBufferHeader header;
+	std::memcpy(header.magic, INDEX_BUFFER_MAGIC, sizeof(header.magic));
+	header.version = INDEX_BUFFER_VERSION;
+	header.index_size = index_size;
+	header.content = content;
+	header.num_indices = num_indices;
+	header.num_strips = (content == CONTENT_STRIPS) ? lengths.size() : 0;
+	if (index_size == 2) {
+		header.restart_index = boost::uint16_t(restart_index);
+		header.num_triangles = count_triangles(content, static_cast<const boost::uint16_t *>(indices),
+		                                       num_indices, lengths, boost::uint16_t(restart_index));
+	} else if (index_size == 4) {
+		header.restart_index = restart_index;
+		header.num_triangles = count_triangles(content, static_cast<const boost::uint32_t *>(indices),
+		                                       num_indices, lengths, restart_index);
+	} else {
+		throw std::runtime_error("Index size must be 2 or 4.");
+	};
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Cannot open " + filename + ".");
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(static_cast<const char *>(indices), num_indices * index_size);
+	if (header.num_strips) {
+		static const char padding[8] = {0};
+		boost::uint64_t offset = sizeof(header) + num_indices * index_size;
+		file.write(padding, get_lengths_offset(header) - offset);
+		std::vector<boost::uint64_t> strip_lengths(lengths.begin(), lengths.end());
+		file.write(reinterpret_cast<const char *>(strip_lengths.data()),
+		           8 * strip_lengths.size());
+	};
+	file.close();
+	if (!file)
+		throw std::runtime_error("Cannot write " + filename + ".");
+}
+
+//! Stripify triangles of Index type from input, and write to output.
+template <typename Index>
+static void stripify_file(const IndexBufferFile & input, const std::string & output_filename,
+                          const StripifyOptions & options)
+{
+	std::vector<Index> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(input.get_indices<Index>(), input.get_header().num_indices / 3,
+	         strip_indices, strip_lengths, options);
+	IndexBufferContent contents[] = {
+		CONTENT_STRIPS, CONTENT_STITCHED_STRIP, CONTENT_RESTART_STRIP, CONTENT_TRIANGLES
+	};
+	write_index_buffer(output_filename, contents[options.output], sizeof(Index),
+	                   strip_indices.data(), strip_indices.size(), strip_lengths,
+	                   options.restart_index);
+}
+
+void stripify_file(const std::string & input_filename, const std::string & output_filename,
+                   const StripifyOptions & options)
+{
+	IndexBufferFile input(input_filename);
+	const IndexBufferHeader & header = input.get_header();
+	if ((header.content != CONTENT_TRIANGLES) || (header.num_indices % 3))
+		throw std::runtime_error("Index buffer file does not hold triangles.");
+	if (header.index_size == 2) {
+		stripify_file<boost::uint16_t>(input, output_filename, options);
+	} else {
+		stripify_file<boost::uint32_t>(input, output_filename, options);
+	};
+}
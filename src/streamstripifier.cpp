@@ -0,0 +1,219 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::sort std::unique std::binary_search
+#include <deque>
+#include <list>
+#include <stdexcept>
+
+#include <boost/foreach.hpp>
+
+#include "streamstripifier.hpp"
+#include "stripstitcher.hpp"
+#include "trianglemesh.hpp"
+#include "trianglestripifier.hpp"
+
+//! Number of triangles read at once by stripify_stream.
+static const std::size_t STREAM_BLOCK_TRIANGLES = 65536;
+
+//! Key of the undirected edge between two vertices.
+static boost::uint64_t undirected_edge_key(int v0, int v1)
+{
+	return (v0 < v1) ? Edge(v0, v1).key() : Edge(v1, v0).key();
+}
+
+const std::size_t StreamStripifier::BYTES_PER_TRIANGLE;
+const std::size_t StreamStripifier::MIN_CHUNK_TRIANGLES;
+
+StreamStripifier::StreamStripifier(std::ostream & _output, std::size_t memory_budget,
+                                   const StripifyOptions & _options)
+	: max_chunk_triangles(std::max(MIN_CHUNK_TRIANGLES, memory_budget / BYTES_PER_TRIANGLE)),
+	  num_triangles(0), num_chunks(0), num_strips(0), num_indices(0),
+	  output(_output), options(_options), chunk(), next(), carried(), last_index(0) {};
+
+void StreamStripifier::add_triangles(const boost::uint32_t *indices, std::size_t num_new_triangles)
+{
+	// every chunk gets half its size in new triangles, leaving
+	// room for the triangles carried over
+	std::size_t step = max_chunk_triangles / 2;
+	while (num_new_triangles > 0) {
+		std::size_t count = std::min(num_new_triangles, step - next.size() / 3);
+		next.insert(next.end(), indices, indices + 3 * count);
+		indices += 3 * count;
+		num_new_triangles -= count;
+		num_triangles += count;
+		if (next.size() == 3 * step) {
+			// next chunk is complete, so the current one can
+			// be stripified
+			stripify_chunk();
+			chunk.swap(carried);
+			chunk.insert(chunk.end(), next.begin(), next.end());
+			next.clear();
+		};
+	};
+}
+
+void StreamStripifier::finish()
+{
+	stripify_chunk();
+	chunk.swap(carried);
+	chunk.insert(chunk.end(), next.begin(), next.end());
+	next.clear();
+	// nothing is carried over from the last chunk
+	stripify_chunk();
+	chunk.clear();
+	output.flush();
+}
+
+void StreamStripifier::stripify_chunk()
+{
+	carried.clear();
+	std::size_t chunk_triangles = chunk.size() / 3;
+	if (chunk_triangles == 0) return;
+	num_chunks++;
+	if (options.output == OUTPUT_TRIANGLE_LIST) {
+		std::vector<boost::uint32_t> indices;
+		std::vector<std::size_t> lengths;
+		stripify(chunk.data(), chunk_triangles, indices, lengths, options);
+		write(indices.data(), indices.size());
+		return;
+	};
+	if (options.output == OUTPUT_RESTART_STRIP) {
+		if (std::find(chunk.begin(), chunk.end(), options.restart_index) != chunk.end())
+			throw std::runtime_error("Vertex index equals restart index.");
+	};
+	if (options.num_samples < 1)
+		throw std::runtime_error("Number of samples must be positive.");
+	MeshPtr mesh(new Mesh(chunk.data(), chunk_triangles, options.stats));
+	TriangleStripifier stripifier(mesh, options.num_threads, options.cache_size,
+	                              options.resource ? options.resource
+	                              : std::pmr::get_default_resource());
+	stripifier.selector.num_samples = options.num_samples;
+	stripifier.stats = options.stats;
+	std::list<TriangleStripPtr> strips = stripifier.find_all_strips();
+	// edges shared with the next chunk
+	std::vector<boost::uint64_t> border;
+	border.reserve(next.size());
+	for (std::size_t i = 0; i < next.size(); i += 3) {
+		// degenerate triangles are dropped by Mesh, so they have
+		// no edges to share
+		if ((next[i] == next[i + 1]) || (next[i + 1] == next[i + 2])
+		    || (next[i + 2] == next[i]))
+			continue;
+		border.push_back(undirected_edge_key(next[i], next[i + 1]));
+		border.push_back(undirected_edge_key(next[i + 1], next[i + 2]));
+		border.push_back(undirected_edge_key(next[i + 2], next[i]));
+	};
+	std::sort(border.begin(), border.end());
+	border.erase(std::unique(border.begin(), border.end()), border.end());
+	// carry over strips along the border, and write all others
+	std::size_t max_carried = max_chunk_triangles / 2;
+	std::vector<std::deque<int> > stitch;
+	BOOST_FOREACH(TriangleStripPtr strip, strips) {
+		bool along_border = false;
+		if (!border.empty() && (carried.size() / 3 + strip->faces.size() <= max_carried)) {
+			BOOST_FOREACH(int face, strip->faces) {
+				const Face & f = mesh->faces[face];
+				if (std::binary_search(border.begin(), border.end(), undirected_edge_key(f.v0, f.v1))
+				    || std::binary_search(border.begin(), border.end(), undirected_edge_key(f.v1, f.v2))
+				    || std::binary_search(border.begin(), border.end(), undirected_edge_key(f.v2, f.v0))) {
+					along_border = true;
+					break;
+				};
+			};
+		};
+		if (along_border) {
+			BOOST_FOREACH(int face, strip->faces) {
+				const Face & f = mesh->faces[face];
+				carried.push_back(f.v0);
+				carried.push_back(f.v1);
+				carried.push_back(f.v2);
+			};
+		} else if (options.output == OUTPUT_STITCHED_STRIP) {
+			stitch.push_back(strip->get_strip());
+		} else if (options.output == OUTPUT_RESTART_STRIP) {
+			BOOST_FOREACH(const std::deque<int> & vertices, strip->get_split_strip()) {
+				write_strip(vertices);
+			};
+		} else {
+			write_strip(strip->get_strip());
+		};
+	};
+	if (!stitch.empty()) write_strip(stitch_strips(stitch));
+}
+
+void StreamStripifier::write_strip(const std::deque<int> & strip)
+{
+	if (options.output == OUTPUT_STRIPS) {
+		boost::uint32_t length = strip.size();
+		output.write(reinterpret_cast<const char *>(&length), sizeof(length));
+	} else if (options.output == OUTPUT_STITCHED_STRIP) {
+		BOOST_FOREACH(int index, get_stitch_indices(num_indices, last_index, strip)) {
+			boost::uint32_t i = index;
+			write(&i, 1);
+		};
+	} else if ((options.output == OUTPUT_RESTART_STRIP) && (num_indices != 0)) {
+		write(&options.restart_index, 1);
+	};
+	std::vector<boost::uint32_t> indices(strip.begin(), strip.end());
+	write(indices.data(), indices.size());
+	num_strips++;
+}
+
+void StreamStripifier::write(const boost::uint32_t *indices, std::size_t size)
+{
+	if (size == 0) return;
+	output.write(reinterpret_cast<const char *>(indices), size * sizeof(boost::uint32_t));
+	num_indices += size;
+	last_index = indices[size - 1];
+}
+
+void stripify_stream(std::istream & input, std::ostream & output,
+                     std::size_t memory_budget, const StripifyOptions & options)
+{
+	StreamStripifier stripifier(output, memory_budget, options);
+	std::vector<boost::uint32_t> buffer(3 * STREAM_BLOCK_TRIANGLES);
+	while (input) {
+		input.read(reinterpret_cast<char *>(buffer.data()),
+		           buffer.size() * sizeof(boost::uint32_t));
+		std::size_t size = input.gcount();
+		if (size % (3 * sizeof(boost::uint32_t)))
+			throw std::runtime_error("Incomplete triangle at end of input.");
+		stripifier.add_triangles(buffer.data(), size / (3 * sizeof(boost::uint32_t)));
+	};
+	stripifier.finish();
+}
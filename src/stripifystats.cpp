@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::max
+
+#include "stripifystats.hpp"
+
+StripifyStats::StripifyStats()
+{
+	clear();
+}
+
+void StripifyStats::clear()
+{
+	num_triangles = 0;
+	num_degenerate_triangles = 0;
+	num_duplicate_triangles = 0;
+	num_faces = 0;
+	num_rounds = 0;
+	num_experiments = 0;
+	num_aborted_experiments = 0;
+	num_traversed_faces = 0;
+	num_adjacency_probes = 0;
+	num_reset_points = 0;
+	num_reset_point_skips = 0;
+	strip_length_histogram.clear();
+	face_seconds = 0.0;
+	adjacency_seconds = 0.0;
+	reset_point_seconds = 0.0;
+	experiment_seconds = 0.0;
+	commit_seconds = 0.0;
+}
+
+void StripifyStats::add(const StripifyStats & stats)
+{
+	num_triangles += stats.num_triangles;
+	num_degenerate_triangles += stats.num_degenerate_triangles;
+	num_duplicate_triangles += stats.num_duplicate_triangles;
+	num_faces += stats.num_faces;
+	num_rounds += stats.num_rounds;
+	num_experiments += stats.num_experiments;
+	num_aborted_experiments += stats.num_aborted_experiments;
+	num_traversed_faces += stats.num_traversed_faces;
+	num_adjacency_probes += stats.num_adjacency_probes;
+	num_reset_points += stats.num_reset_points;
+	num_reset_point_skips += stats.num_reset_point_skips;
+	strip_length_histogram.resize(std::max(strip_length_histogram.size(),
+	                                       stats.strip_length_histogram.size()), 0);
+	for (std::size_t i = 0; i < stats.strip_length_histogram.size(); i++)
+		strip_length_histogram[i] += stats.strip_length_histogram[i];
+	face_seconds += stats.face_seconds;
+	adjacency_seconds += stats.adjacency_seconds;
+	reset_point_seconds += stats.reset_point_seconds;
+	experiment_seconds += stats.experiment_seconds;
+	commit_seconds += stats.commit_seconds;
+}
+
+void StripifyStats::add_strip(std::size_t num_strip_faces)
+{
+	if (strip_length_histogram.size() <= num_strip_faces)
+		strip_length_histogram.resize(num_strip_faces + 1, 0);
+	strip_length_histogram[num_strip_faces]++;
+}
+
+std::size_t StripifyStats::get_num_strips() const
+{
+	std::size_t num_strips = 0;
+	for (std::size_t i = 0; i < strip_length_histogram.size(); i++)
+		num_strips += strip_length_histogram[i];
+	return num_strips;
+}
@@ -0,0 +1,208 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::sort std::lower_bound
+#include <utility> // std::pair
+
+#include "stripstitcher.hpp"
+
+//! Can a strip of given length start at position pos of the stitched
+//! strip, in given direction, without changing its winding?
+static bool is_valid_start(std::size_t pos, std::size_t length, bool reversed)
+{
+	if (pos & 1) {
+		// faces are flipped, which only reversing an odd strip
+		// undoes
+		return reversed && (length & 1);
+	} else {
+		// reversing keeps winding only for even strips
+		return !reversed || !(length & 1);
+	}
+}
+
+//! Position where a strip can start after a stitched strip of given
+//! size, with fewest extra indices. Shared means that the first
+//! vertex of the strip equals the last vertex of the stitched strip.
+static std::size_t get_start(std::size_t size, bool shared,
+                             std::size_t length, bool reversed)
+{
+	std::size_t pos = (size == 0) ? 0 : (shared ? size : size + 2);
+	if (!is_valid_start(pos, length, reversed)) pos++;
+	return pos;
+}
+
+//! The ends of all strips, sorted by vertex, so the strips ending
+//! with a given vertex can be found quickly, and removed once
+//! stitched. End 2 * s is the first vertex of strip s, and end
+//! 2 * s + 1 its last vertex.
+class StripEnds
+{
+public:
+	StripEnds(const std::vector<std::deque<int> > & strips)
+		: ends(), group(), group_first(), group_size(), pos(2 * strips.size())
+	{
+		for (std::size_t s = 0; s < strips.size(); s++) {
+			ends.push_back(std::make_pair(strips[s].front(), 2 * s));
+			ends.push_back(std::make_pair(strips[s].back(), 2 * s + 1));
+		}
+		std::sort(ends.begin(), ends.end());
+		for (std::size_t i = 0; i < ends.size(); i++) {
+			if ((i == 0) || (ends[i].first != ends[i - 1].first)) {
+				group_first.push_back(i);
+				group_size.push_back(0);
+			}
+			group.push_back(group_first.size() - 1);
+			group_size.back()++;
+			pos[ends[i].second] = i;
+		}
+	};
+
+	//! Ends with given vertex, of strips not yet removed, in
+	//! [first, first + size).
+	void find(int vertex, const std::pair<int, int> * & first, int & size) const
+	{
+		std::vector<std::pair<int, int> >::const_iterator i
+		    = std::lower_bound(ends.begin(), ends.end(), std::make_pair(vertex, -1));
+		size = 0;
+		if ((i != ends.end()) && (i->first == vertex)) {
+			first = &*i;
+			size = group_size[group[i - ends.begin()]];
+		}
+	};
+
+	//! Remove both ends of strip.
+	void remove(int strip)
+	{
+		remove_end(2 * strip);
+		remove_end(2 * strip + 1);
+	};
+
+private:
+	//! Swap end with the last end of its group, and shrink the
+	//! group.
+	void remove_end(int end)
+	{
+		int g = group[pos[end]];
+		int last = group_first[g] + --group_size[g];
+		int other = ends[last].second;
+		std::swap(ends[pos[end]], ends[last]);
+		std::swap(pos[end], pos[other]);
+	};
+
+	std::vector<std::pair<int, int> > ends;
+	//! Group of each position, one group per vertex.
+	std::vector<int> group;
+	std::vector<int> group_first;
+	//! Number of ends in each group not yet removed.
+	std::vector<int> group_size;
+	//! Position of each end.
+	std::vector<int> pos;
+};
+
+std::deque<int> stitch_strips(const std::vector<std::deque<int> > & strips)
+{
+	std::deque<int> result;
+	StripEnds ends(strips);
+	std::vector<bool> stitched(strips.size(), false);
+	std::size_t next_strip = 0; // all strips before this are stitched
+	for (std::size_t n = 0; n < strips.size(); n++) {
+		int best_strip = -1;
+		bool best_reversed = false;
+		std::size_t best_start = 0;
+		// look for a strip sharing the last vertex
+		if (!result.empty()) {
+			const std::pair<int, int> *first = 0;
+			int size;
+			ends.find(result.back(), first, size);
+			for (int i = 0; i < size; i++) {
+				int strip = first[i].second / 2;
+				bool reversed = first[i].second & 1;
+				std::size_t start = get_start(result.size(), true,
+				                              strips[strip].size(), reversed);
+				if ((best_strip == -1) || (start < best_start)
+				    || ((start == best_start) && (strip < best_strip))) {
+					best_strip = strip;
+					best_reversed = reversed;
+					best_start = start;
+				}
+			}
+		}
+		// otherwise, take the next strip
+		if (best_strip == -1) {
+			while (stitched[next_strip]) next_strip++;
+			best_strip = next_strip;
+			std::size_t length = strips[best_strip].size();
+			best_start = get_start(result.size(), false, length, false);
+			std::size_t reversed_start = get_start(result.size(), false, length, true);
+			if (reversed_start < best_start) {
+				best_reversed = true;
+				best_start = reversed_start;
+			}
+		}
+		stitched[best_strip] = true;
+		ends.remove(best_strip);
+		// join with degenerate triangles: repeat the last vertex,
+		// then the first vertex of the strip as often as needed
+		const std::deque<int> & strip = strips[best_strip];
+		int first_vertex = best_reversed ? strip.back() : strip.front();
+		if (best_start > result.size()) {
+			int last_vertex = result.back();
+			std::size_t num_first = best_start - result.size() - 1;
+			result.push_back(last_vertex);
+			result.insert(result.end(), num_first, first_vertex);
+		}
+		if (best_reversed) {
+			result.insert(result.end(), strip.rbegin(), strip.rend());
+		} else {
+			result.insert(result.end(), strip.begin(), strip.end());
+		}
+	}
+	return result;
+}
+
+std::vector<int> get_stitch_indices(std::size_t size, int last_vertex,
+                                    const std::deque<int> & strip)
+{
+	std::vector<int> result;
+	std::size_t start = get_start(size, (size != 0) && (strip.front() == last_vertex),
+	                              strip.size(), false);
+	if (start > size) {
+		result.push_back(last_vertex);
+		result.insert(result.end(), start - size - 1, strip.front());
+	}
+	return result;
+}
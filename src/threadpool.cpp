@@ -0,0 +1,161 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "threadpool.hpp"
+
+ThreadPool::ThreadPool(int num_threads)
+	: num_workers(num_threads), queues(), threads(), mutex(),
+	  job_started(), job_finished(), job_id(0), job_task(0),
+	  num_busy(0), error(), failed(false), stopping(false)
+{
+	if (num_workers <= 0)
+		num_workers = std::thread::hardware_concurrency();
+	if (num_workers <= 0)
+		num_workers = 1;
+	queues.reset(new WorkQueue[num_workers]);
+	// the calling thread is worker 0
+	for (int worker = 1; worker < num_workers; worker++)
+		threads.push_back(std::thread(&ThreadPool::work, this, worker));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	job_started.notify_all();
+	for (std::size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+int ThreadPool::size() const
+{
+	return num_workers;
+}
+
+void ThreadPool::run(int num_tasks, const Task & task)
+{
+	if ((num_workers == 1) || (num_tasks <= 1)) {
+		// nothing to gain from waking up the workers
+		for (int i = 0; i < num_tasks; i++) task(i, 0);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// deal tasks to the queues
+		for (int worker = 0; worker < num_workers; worker++)
+			queues[worker].tasks.clear();
+		for (int i = 0; i < num_tasks; i++)
+			queues[i % num_workers].tasks.push_back(i);
+		for (int worker = 0; worker < num_workers; worker++) {
+			queues[worker].front = 0;
+			queues[worker].back = queues[worker].tasks.size();
+		}
+		job_id++;
+		job_task = &task;
+		num_busy = num_workers;
+		error = std::exception_ptr();
+		failed = false;
+	}
+	job_started.notify_all();
+	run_tasks(0);
+	std::unique_lock<std::mutex> lock(mutex);
+	job_finished.wait(lock, [this] {
+		return num_busy == 0;
+	});
+	job_task = 0;
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void ThreadPool::work(int worker)
+{
+	int last_job_id = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			job_started.wait(lock, [this, last_job_id] {
+				return stopping || (job_id != last_job_id);
+			});
+			if (stopping)
+				return;
+			last_job_id = job_id;
+		}
+		run_tasks(worker);
+	}
+}
+
+void ThreadPool::run_tasks(int worker)
+{
+	int task;
+	while (!failed && (pop_task(worker, task) || steal_task(worker, task))) {
+		try {
+			(*job_task)(task, worker);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) error = std::current_exception();
+			failed = true;
+		}
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	if (--num_busy == 0)
+		job_finished.notify_all();
+}
+
+bool ThreadPool::pop_task(int worker, int & task)
+{
+	WorkQueue & queue = queues[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.front == queue.back)
+		return false;
+	task = queue.tasks[queue.front++];
+	return true;
+}
+
+bool ThreadPool::steal_task(int worker, int & task)
+{
+	for (int i = 1; i < num_workers; i++) {
+		WorkQueue & queue = queues[(worker + i) % num_workers];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.front == queue.back)
+			continue;
+		task = queue.tasks[--queue.back];
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,170 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::sort std::unique std::lower_bound
+#include <cmath> // std::pow std::sqrt
+#include <boost/foreach.hpp>
+
+#include "trianglelistoptimizer.hpp"
+
+// score parameters, as suggested by Forsyth
+static const float CACHE_DECAY_POWER = 1.5;
+static const float LAST_FACE_SCORE = 0.75;
+static const float VALENCE_BOOST_SCALE = 2.0;
+
+TriangleListOptimizer::TriangleListOptimizer(MeshPtr _mesh, int _cache_size)
+	: mesh(_mesh), cache_size(std::max(4, _cache_size)) {};
+
+float TriangleListOptimizer::get_vertex_score(int cache_pos, int num_faces) const
+{
+	// vertex not used anymore
+	if (num_faces == 0)
+		return -1.0;
+	float score = 0.0;
+	if (cache_pos < 0) {
+		// not in cache
+	} else if (cache_pos < 3) {
+		// used by the last face, so drawing a face next to it
+		// has a fixed score, whichever edge is shared
+		score = LAST_FACE_SCORE;
+	} else {
+		// the older, the lower the score
+		score = std::pow(1.0f - float(cache_pos - 3) / (cache_size - 3),
+		                 CACHE_DECAY_POWER);
+	}
+	// boost vertices with few faces left, to finish them off
+	return score + VALENCE_BOOST_SCALE / std::sqrt(float(num_faces));
+};
+
+std::vector<int> TriangleListOptimizer::find_face_order()
+{
+	int num_faces = mesh->faces.size();
+	// number vertices consecutively
+	std::vector<int> vertex_ids;
+	vertex_ids.reserve(3 * num_faces);
+	BOOST_FOREACH(const Face & face, mesh->faces) {
+		vertex_ids.push_back(face.v0);
+		vertex_ids.push_back(face.v1);
+		vertex_ids.push_back(face.v2);
+	};
+	std::sort(vertex_ids.begin(), vertex_ids.end());
+	vertex_ids.erase(std::unique(vertex_ids.begin(), vertex_ids.end()),
+	                 vertex_ids.end());
+	int num_vertices = vertex_ids.size();
+	std::vector<int> face_vertices(3 * num_faces);
+	for (int i = 0; i < 3 * num_faces; i++) {
+		const Face & face = mesh->faces[i / 3];
+		int vertex = (i % 3 == 0) ? face.v0 : ((i % 3 == 1) ? face.v1 : face.v2);
+		face_vertices[i] = std::lower_bound(vertex_ids.begin(), vertex_ids.end(), vertex)
+		                   - vertex_ids.begin();
+	};
+	// faces of each vertex; the faces not yet drawn are kept at
+	// the start of each range, and vertex_num_faces counts them
+	std::vector<int> vertex_offsets(num_vertices + 1, 0);
+	BOOST_FOREACH(int vertex, face_vertices) vertex_offsets[vertex + 1]++;
+	for (int vertex = 0; vertex < num_vertices; vertex++)
+		vertex_offsets[vertex + 1] += vertex_offsets[vertex];
+	std::vector<int> vertex_num_faces(num_vertices, 0);
+	std::vector<int> vertex_faces(3 * num_faces);
+	for (int i = 0; i < 3 * num_faces; i++) {
+		int vertex = face_vertices[i];
+		vertex_faces[vertex_offsets[vertex] + vertex_num_faces[vertex]++] = i / 3;
+	};
+	// initial scores
+	std::vector<int> cache_pos(num_vertices, -1);
+	std::vector<float> vertex_score(num_vertices);
+	for (int vertex = 0; vertex < num_vertices; vertex++)
+		vertex_score[vertex] = get_vertex_score(-1, vertex_num_faces[vertex]);
+	// draw faces one by one
+	std::vector<int> result;
+	result.reserve(num_faces);
+	std::vector<bool> drawn(num_faces, false);
+	std::vector<int> cache;
+	std::vector<int> new_cache;
+	int best_face = -1;
+	int next_face = 0; // all faces before this one are drawn
+	while (int(result.size()) < num_faces) {
+		if (best_face == -1) {
+			// no face around the cached vertices: start
+			// afresh from the first face not yet drawn
+			while (drawn[next_face]) next_face++;
+			best_face = next_face;
+		};
+		result.push_back(best_face);
+		drawn[best_face] = true;
+		// move vertices of face to the front of the cache, and
+		// remove face from the faces of its vertices
+		new_cache.clear();
+		for (int j = 0; j < 3; j++) {
+			int vertex = face_vertices[3 * best_face + j];
+			new_cache.push_back(vertex);
+			int *first = &vertex_faces[vertex_offsets[vertex]];
+			int *last = first + vertex_num_faces[vertex]--;
+			std::swap(*std::find(first, last, best_face), *(last - 1));
+		};
+		BOOST_FOREACH(int vertex, cache) {
+			if ((vertex != new_cache[0]) && (vertex != new_cache[1])
+			    && (vertex != new_cache[2]))
+				new_cache.push_back(vertex);
+		};
+		// update scores of vertices in the cache, or just evicted
+		for (int i = 0; i < int(new_cache.size()); i++) {
+			int vertex = new_cache[i];
+			cache_pos[vertex] = (i < cache_size) ? i : -1;
+			vertex_score[vertex] = get_vertex_score(cache_pos[vertex],
+			                                        vertex_num_faces[vertex]);
+		};
+		// score their faces, and pick the best one
+		best_face = -1;
+		float best_score = -1.0;
+		BOOST_FOREACH(int vertex, new_cache) {
+			for (int k = 0; k < vertex_num_faces[vertex]; k++) {
+				int face = vertex_faces[vertex_offsets[vertex] + k];
+				float score = vertex_score[face_vertices[3 * face]]
+				              + vertex_score[face_vertices[3 * face + 1]]
+				              + vertex_score[face_vertices[3 * face + 2]];
+				if (score > best_score) {
+					best_score = score;
+					best_face = face;
+				};
+			};
+		};
+		if (int(new_cache.size()) > cache_size) new_cache.resize(cache_size);
+		cache.swap(new_cache);
+	};
+	return result;
+};
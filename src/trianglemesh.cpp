@@ -62,8 +62,10 @@ POSSIBILITY OF SUCH DAMAGE.
 //~ Imports
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+#include <chrono>
 #include <iostream> // for dump
 #include <stdexcept>
+#include <utility>
 
 #include <boost/foreach.hpp>
 
@@ -94,21 +96,6 @@ bool Edge::operator==(const Edge & otheredge) const
 	return ((ev0 == otheredge.ev0) && (ev1 == otheredge.ev1));
 };
 
-MEdge::MEdge(const Edge & edge) : Edge(edge), faces()
-{
-	// nothing to do: faces are set in Mesh::add_face.
-};
-
-void MEdge::dump() const
-{
-	std::cout << "  edge " << ev0 << "," << ev1 << std::endl;
-	BOOST_FOREACH(boost::weak_ptr<MFace> face, faces) {
-		if (MFacePtr f = face.lock()) {
-			std::cout << "    face " << f->v0 << "," << f->v1 << "," << f->v2 << std::endl;
-		};
-	};
-}
-
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 Face::Face(int _v0, int _v1, int _v2)
@@ -134,6 +121,8 @@ Face::Face(int _v0, int _v1, int _v2)
 	}
 };
 
+Face::Face() : v0(0), v1(0), v2(0) {};
+
 bool Face::operator<(const Face & otherface) const
 {
 	if (v0 < otherface.v0) return true;
@@ -158,129 +147,311 @@ int Face::get_next_vertex(int vi) const
 	throw std::runtime_error("Invalid vertex index.");
 }
 
-MFace::MFace(const Face & face)
-	: Face(face), faces0(), faces1(), faces2(),
-	  strip_id(-1), test_strip_id(-1), experiment_id(-1)
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+FaceRange::FaceRange(const_iterator _first, const_iterator _last)
+	: first(_first), last(_last)
 {
 	// nothing to do
 };
 
-MFace::Faces & MFace::get_adjacent_faces(int vi)
-{
-	if (vi == v0) return faces0;
-	else if (vi == v1) return faces1;
-	else if (vi == v2) return faces2;
-	// bug!
-	else throw std::runtime_error("Invalid vertex index.");
-};
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-void MFace::dump() const
+void Mesh::add_edge(int face, int j, int pv0, int pv1)
 {
-	std::cout << "  face " << v0 << "," << v1 << "," << v2 << std::endl;
-	BOOST_FOREACH(boost::weak_ptr<MFace> face0, faces0) {
-		if (MFacePtr f = face0.lock()) {
-			std::cout << "    face0 " << f->v0 << "," << f->v1 << "," << f->v2 << std::endl;
-		};
-	}
-	BOOST_FOREACH(boost::weak_ptr<MFace> face1, faces1) {
-		if (MFacePtr f = face1.lock()) {
-			std::cout << "    face1 " << f->v0 << "," << f->v1 << "," << f->v2 << std::endl;
-		};
-	}
-	BOOST_FOREACH(boost::weak_ptr<MFace> face2, faces2) {
-		if (MFacePtr f = face2.lock()) {
-			std::cout << "    face2 " << f->v0 << "," << f->v1 << "," << f->v2 << std::endl;
-		};
+	// add edge to edge map, and append occurrence to the list of
+	// occurrences of this edge; adjacent faces are the faces of the
+	// reverse edge, these are collected when the mesh is locked
+	int occurrence = 3 * face + j;
+	std::size_t num_edges = _edges.size();
+	std::pair<int, int> & edge = _edges[Edge(pv0, pv1).key()];
+	if (_edges.size() != num_edges) {
+		// new edge
+		edge.first = occurrence;
+	} else {
+		_edge_next[edge.second] = occurrence;
 	}
+	edge.second = occurrence;
 }
 
-//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Mesh::Mesh()
+	: locked(false), _faces(), _edges(), _edge_next(), faces(),
+	  adjacency_offsets(), adjacency() {};
 
-void Mesh::add_edge(MFacePtr face, int pv0, int pv1)
+//! Stable sort of keys, moving values along, by least significant
+//! digit radix sort on bytes. Bytes which are equal for all keys
+//! (typically, the high bytes of packed vertex indices) take no
+//! pass.
+static void radix_sort(std::vector<boost::uint64_t> & keys,
+                       std::vector<int> & values)
 {
-	// add edge to edge map
-
-	// create edge index and search for edge in mesh
-	Edge edge01_index(pv0, pv1);
-	EdgeMap::const_iterator edge01_iter = _edges.find(edge01_index);
-	if (edge01_iter != _edges.end()) {
-		// edge already exists!
-		// update list of faces that have this edge
-		edge01_iter->second->faces.push_back(face);
-	} else {
-		// create edge
-		MEdgePtr edge01(new MEdge(edge01_index));
-		_edges[edge01_index] = edge01;
-		// update list of faces that have this edge
-		edge01->faces.push_back(face);
+	std::size_t num_keys = keys.size();
+	if (num_keys < 2)
+		return;
+	std::vector<boost::uint64_t> sorted_keys(num_keys);
+	std::vector<int> sorted_values(num_keys);
+	for (int shift = 0; shift < 64; shift += 8) {
+		std::size_t offsets[256] = {0};
+		for (std::size_t i = 0; i < num_keys; i++)
+			offsets[(keys[i] >> shift) & 0xff]++;
+		if (offsets[(keys[0] >> shift) & 0xff] == num_keys)
+			continue;
+		std::size_t offset = 0;
+		for (int digit = 0; digit < 256; digit++) {
+			std::size_t count = offsets[digit];
+			offsets[digit] = offset;
+			offset += count;
+		};
+		for (std::size_t i = 0; i < num_keys; i++) {
+			std::size_t j = offsets[(keys[i] >> shift) & 0xff]++;
+			sorted_keys[j] = keys[i];
+			sorted_values[j] = values[i];
+		};
+		keys.swap(sorted_keys);
+		values.swap(sorted_values);
 	};
+}
 
-	// find adjacent faces
-
-	//    pv0---other_pv2
-	//   /  \  /
-	// pv2---pv1
+template <typename Index>
+Mesh::Mesh(const Index *indices, std::size_t num_triangles, StripifyStats *stats)
+	: locked(false), _faces(), _edges(), _edge_next(), faces(),
+	  adjacency_offsets(), adjacency()
+{
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start;
+	if (stats) start = Clock::now();
+
+	// canonicalize all non-degenerate triangles
+	std::vector<Face> candidates;
+	candidates.reserve(num_triangles);
+	for (std::size_t i = 0; i < num_triangles; i++) {
+		int v0 = indices[3 * i];
+		int v1 = indices[3 * i + 1];
+		int v2 = indices[3 * i + 2];
+		if ((v0 != v1) && (v1 != v2) && (v2 != v0))
+			candidates.push_back(Face(v0, v1, v2));
+	};
 
-	// with other_pv0 == pv1
-	// with other_pv1 == pv0
-
-	// create reverse edge index and search for reverse edge in mesh
-	Edge edge10_index(pv1, pv0);
-	EdgeMap::const_iterator edge10_iter = _edges.find(edge10_index);
-	if (edge10_iter != _edges.end()) {
-		// the faces of the reverse edge are adjacent faces
-		MEdgePtr edge10(edge10_iter->second);
-		// find opposite vertex of face
-		int pv2 = face->get_next_vertex(pv1);
-		BOOST_FOREACH(boost::weak_ptr<MFace> _otherface,
-		              edge10->faces) {
-			if (MFacePtr otherface = _otherface.lock()) {
-				int other_pv2 = otherface->get_next_vertex(pv0);
-				face->get_adjacent_faces(pv2).push_back(otherface);
-				otherface->get_adjacent_faces(other_pv2).push_back(face);
+	// find duplicates: sort candidates on (v0, v1, v2), the first
+	// candidate of each run of equal faces is the one to keep
+	std::vector<boost::uint64_t> keys(candidates.size());
+	std::vector<int> values(candidates.size());
+	for (std::size_t i = 0; i < candidates.size(); i++) {
+		keys[i] = Edge(candidates[i].v1, candidates[i].v2).key();
+		values[i] = i;
+	};
+	radix_sort(keys, values);
+	for (std::size_t i = 0; i < candidates.size(); i++)
+		keys[i] = boost::uint32_t(candidates[values[i]].v0);
+	radix_sort(keys, values);
+	std::vector<bool> keep(candidates.size(), false);
+	for (std::size_t i = 0; i < candidates.size(); i++) {
+		if ((i == 0) || !(candidates[values[i]] == candidates[values[i - 1]]))
+			keep[values[i]] = true;
+	};
+	faces.reserve(candidates.size());
+	for (std::size_t i = 0; i < candidates.size(); i++) {
+		if (keep[i]) faces.push_back(candidates[i]);
+	};
+	if (stats) {
+		stats->num_triangles += num_triangles;
+		stats->num_degenerate_triangles += num_triangles - candidates.size();
+		stats->num_duplicate_triangles += candidates.size() - faces.size();
+		stats->num_faces += faces.size();
+		Clock::time_point now = Clock::now();
+		stats->face_seconds += std::chrono::duration<double>(now - start).count();
+		start = now;
+	};
+	std::vector<Face>().swap(candidates);
+
+	// sort all edge occurrences 3 * face + j on their edge, and
+	// separately on their reverse edge; edge j of a face is the
+	// edge opposite its vertex (j + 2) % 3
+	int num_occurrences = 3 * faces.size();
+	keys.resize(num_occurrences);
+	values.resize(num_occurrences);
+	std::vector<boost::uint64_t> reverse_keys(num_occurrences);
+	std::vector<int> reverse_values(num_occurrences);
+	for (int face = 0; face < num_occurrences / 3; face++) {
+		int vertices[] = {faces[face].v0, faces[face].v1, faces[face].v2};
+		for (int j = 0; j < 3; j++) {
+			int pv0 = vertices[j];
+			int pv1 = vertices[(j + 1) % 3];
+			keys[3 * face + j] = Edge(pv0, pv1).key();
+			values[3 * face + j] = 3 * face + j;
+			reverse_keys[3 * face + j] = Edge(pv1, pv0).key();
+			reverse_values[3 * face + j] = 3 * face + j;
+		};
+	};
+	radix_sort(keys, values);
+	radix_sort(reverse_keys, reverse_values);
+
+	// merge both lists: faces adjacent along edge j of a face are
+	// the faces which have its reverse edge, and as the sort is
+	// stable, these come in order of face index; first count them
+	// to get the adjacency offsets, then fill in the faces
+	adjacency_offsets.assign(num_occurrences + 1, 0);
+	for (int pass = 0; pass < 2; pass++) {
+		int i = 0;
+		int k = 0;
+		while ((i < num_occurrences) && (k < num_occurrences)) {
+			if (keys[i] < reverse_keys[k]) {
+				i++;
+			} else if (reverse_keys[k] < keys[i]) {
+				k++;
+			} else {
+				// find both runs with this key
+				boost::uint64_t key = keys[i];
+				int i_end = i;
+				while ((i_end < num_occurrences) && (keys[i_end] == key)) i_end++;
+				for (; (k < num_occurrences) && (reverse_keys[k] == key); k++) {
+					int occurrence = reverse_values[k];
+					int slot = occurrence - occurrence % 3 + (occurrence + 2) % 3;
+					if (pass == 0) {
+						adjacency_offsets[slot] = i_end - i;
+					} else {
+						int pos = adjacency_offsets[slot];
+						for (int l = i; l < i_end; l++)
+							adjacency[pos++] = values[l] / 3;
+					}
+				};
+				i = i_end;
+			}
+		};
+		if (pass == 0) {
+			// turn counts into offsets
+			int offset = 0;
+			for (int slot = 0; slot <= num_occurrences; slot++) {
+				int count = adjacency_offsets[slot];
+				adjacency_offsets[slot] = offset;
+				offset += count;
 			};
+			adjacency.resize(offset);
 		};
 	};
+
+	locked = true;
+	if (stats)
+		stats->adjacency_seconds += std::chrono::duration<double>(Clock::now() - start).count();
 }
 
-Mesh::Mesh() : _faces(), _edges(), faces() {};
+template Mesh::Mesh(const int *indices, std::size_t num_triangles, StripifyStats *stats);
+template Mesh::Mesh(const boost::uint16_t *indices, std::size_t num_triangles, StripifyStats *stats);
+template Mesh::Mesh(const boost::uint32_t *indices, std::size_t num_triangles, StripifyStats *stats);
 
-MFacePtr Mesh::add_face(int v0, int v1, int v2)
+int Mesh::add_face(int v0, int v1, int v2)
 {
+	if (locked)
+		throw std::runtime_error("Cannot add face to locked mesh.");
 	// create face index and search if face already exists in mesh
 	Face face_index(v0, v1, v2);
 	FaceMap::const_iterator face_iter = _faces.find(face_index);
 	if (face_iter != _faces.end()) {
 		// face already exists!
-		if (MFacePtr old_face = face_iter->second.lock()) {
-			return old_face;
-		}
+		return face_iter->second;
 	}
 	// create face
-	MFacePtr face(new MFace(face_index));
+	int face = faces.size();
 	_faces[face_index] = face;
-	faces.push_back(face);
-	// create edges and update links between faces
-	add_edge(face, v0, v1);
-	add_edge(face, v1, v2);
-	add_edge(face, v2, v0);
+	faces.push_back(face_index);
+	// create edges
+	_edge_next.resize(3 * faces.size(), -1);
+	add_edge(face, 0, v0, v1);
+	add_edge(face, 1, v1, v2);
+	add_edge(face, 2, v2, v0);
 	return face;
 }
 
+void Mesh::reserve(int num_faces)
+{
+	faces.reserve(num_faces);
+	_faces.reserve(num_faces);
+	_edges.reserve(3 * num_faces);
+	_edge_next.reserve(3 * num_faces);
+}
+
 void Mesh::lock()
 {
+	if (locked)
+		return;
+	// build adjacency arrays
+
+	//    pv0---other_pv2
+	//   /  \  /
+	// pv2---pv1
+
+	// the faces adjacent to the edge (pv0, pv1) opposite pv2 are
+	// the faces of the reverse edge (pv1, pv0); as occurrences are
+	// appended to the edge lists in order, adjacent faces are
+	// sorted by index
+	int num_faces = faces.size();
+	adjacency_offsets.resize(3 * num_faces + 1);
+	adjacency.clear();
+	for (int face = 0; face < num_faces; face++) {
+		int vertices[] = {faces[face].v0, faces[face].v1, faces[face].v2};
+		for (int k = 0; k < 3; k++) {
+			adjacency_offsets[3 * face + k] = adjacency.size();
+			int pv0 = faces[face].get_next_vertex(vertices[k]);
+			int pv1 = faces[face].get_next_vertex(pv0);
+			EdgeMap::const_iterator edge10_iter = _edges.find(Edge(pv1, pv0).key());
+			if (edge10_iter != _edges.end()) {
+				for (int occurrence = edge10_iter->second.first;
+				     occurrence != -1;
+				     occurrence = _edge_next[occurrence]) {
+					adjacency.push_back(occurrence / 3);
+				};
+			};
+		};
+	};
+	adjacency_offsets[3 * faces.size()] = adjacency.size();
+	// free memory
 	_edges.clear();
 	_faces.clear();
+	std::vector<int>().swap(_edge_next);
+	locked = true;
 }
 
+FaceRange Mesh::get_adjacent_faces(int face, int vi) const
+{
+	if (!locked)
+		throw std::runtime_error("Mesh is not locked.");
+	int k;
+	if (vi == faces[face].v0) k = 0;
+	else if (vi == faces[face].v1) k = 1;
+	else if (vi == faces[face].v2) k = 2;
+	// bug!
+	else throw std::runtime_error("Invalid vertex index.");
+	const int *offsets = &adjacency_offsets[3 * face + k];
+	return FaceRange(adjacency.data() + offsets[0],
+	                 adjacency.data() + offsets[1]);
+};
+
 void Mesh::dump() const
 {
-	std::cout << faces.size() << " faces" << std::endl;
-	BOOST_FOREACH(MFacePtr face, faces) {
-		face->dump();
+	int num_faces = faces.size();
+	std::cout << num_faces << " faces" << std::endl;
+	for (int face = 0; face < num_faces; face++) {
+		const Face & f = faces[face];
+		std::cout << "  face " << f.v0 << "," << f.v1 << "," << f.v2 << std::endl;
+		if (!locked)
+			continue;
+		int vertices[] = {f.v0, f.v1, f.v2};
+		for (int k = 0; k < 3; k++) {
+			BOOST_FOREACH(int otherface, get_adjacent_faces(face, vertices[k])) {
+				const Face & o = faces[otherface];
+				std::cout << "    face" << k << " " << o.v0 << "," << o.v1 << "," << o.v2 << std::endl;
+			};
+		};
 	};
 	std::cout << _edges.size() << " edges" << std::endl;
-	BOOST_FOREACH(EdgeMap::value_type edge, _edges) {
-		edge.second->dump();
+	BOOST_FOREACH(const EdgeMap::Entry & edge, _edges) {
+		std::cout << "  edge " << int(edge.first >> 32) << "," << int(edge.first) << std::endl;
+		for (int occurrence = edge.second.first;
+		     occurrence != -1;
+		     occurrence = _edge_next[occurrence]) {
+			const Face & f = faces[occurrence / 3];
+			std::cout << "    face " << f.v0 << "," << f.v1 << "," << f.v2 << std::endl;
+		};
 	};
 }
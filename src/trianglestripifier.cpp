@@ -52,8 +52,8 @@ POSSIBILITY OF SUCH DAMAGE.
 
 //#define DEBUG 1 // XXX remove when done debugging
 
-#include <algorithm> // std::copy
-#include <iterator> // std:front_inserter std::back_inserter
+#include <algorithm> // std::max
+#include <chrono>
 #include <vector>
 
 #include "trianglestripifier.hpp"
@@ -62,61 +62,97 @@ POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #endif
 
-TriangleStrip::TriangleStrip(int _experiment_id)
-	: faces(), vertices(), reversed(false),
-	  strip_id(TriangleStrip::NUM_STRIPS++),
-	  experiment_id(_experiment_id) {};
+//! Number of cache entries that a strip leaves for the vertices of
+//! the adjacent strip, as in NvTriStrip.
+static const int CACHE_INEFFICIENCY = 6;
 
-bool TriangleStrip::is_face_marked(MFacePtr face)
+ExperimentMarks::ExperimentMarks(int num_faces)
+	: experiment_id(num_faces, -1) {};
+
+StripifierContext::StripifierContext(const Mesh & _mesh, int num_marks, int _cache_size,
+                                     std::pmr::memory_resource *_resource)
+	: mesh(_mesh), strip_id(_mesh.faces.size(), -1),
+	  marks(num_marks, ExperimentMarks(_mesh.faces.size())),
+	  num_strips(0), num_experiments(0), num_free_faces(_mesh.faces.size()),
+	  free_faces(_mesh.faces.size(), true), cache_size(_cache_size),
+	  max_strip_faces(_cache_size > 0 ? std::max(1, _cache_size - CACHE_INEFFICIENCY) : 0),
+	  cache(_cache_size), resource(_resource), count_probes(false) {};
+
+void StripifierContext::set_strip_id(int face, int id)
+{
+	strip_id[face] = id;
+	if (id != -1) {
+		free_faces.reset(face);
+	} else {
+		free_faces.set(face);
+	};
+}
+
+TriangleStrip::TriangleStrip(StripifierContext & _context, ExperimentMarks & _marks, int _experiment_id,
+                             std::pmr::memory_resource *resource)
+	: context(_context), mesh(_context.mesh), marks(_marks),
+	  faces(resource), vertices(resource), reversed(false),
+	  experiment_id(_experiment_id), strip_id(-1), num_probes(0) {};
+
+TriangleStrip::TriangleStrip(const TriangleStrip & strip, std::pmr::memory_resource *resource)
+	: context(strip.context), mesh(strip.mesh), marks(strip.marks),
+	  faces(strip.faces, resource), vertices(strip.vertices, resource),
+	  reversed(strip.reversed), experiment_id(strip.experiment_id),
+	  strip_id(strip.strip_id), num_probes(strip.num_probes) {};
+
+bool TriangleStrip::is_face_marked(int face)
 {
 	// does it belong to a final strip?
-	bool result = (face->strip_id != -1);
+	bool result = (context.strip_id[face] != -1);
 	// it does not belong to a final strip... does it
 	// belong to the current experiment?
 	if ((!result) && (experiment_id != -1)) {
-		result = (face->experiment_id == experiment_id);
+		result = (marks.experiment_id[face] == experiment_id);
 	};
 	return result;
 }
 
-void TriangleStrip::mark_face(MFacePtr face)
+void TriangleStrip::mark_face(int face)
 {
 	if (experiment_id != -1) {
-		face->strip_id = -1;
-		face->experiment_id = experiment_id;
-		face->test_strip_id = strip_id;
+		marks.experiment_id[face] = experiment_id;
 	} else {
-		face->strip_id = strip_id;
-		face->experiment_id = -1;
-		face->test_strip_id = -1;
+		context.set_strip_id(face, strip_id);
 	}
 }
 
-MFacePtr TriangleStrip::get_unmarked_adjacent_face(MFacePtr face, int vi)
+int TriangleStrip::get_unmarked_adjacent_face(int face, int vi)
 {
-	BOOST_FOREACH(boost::weak_ptr<MFace> _otherface, face->get_adjacent_faces(vi)) {
-		if (MFacePtr otherface = _otherface.lock()) {
-			if (!is_face_marked(otherface)) {
-				return otherface;
-			}
+	FaceRange otherfaces = mesh.get_adjacent_faces(face, vi);
+	for (FaceRange::const_iterator otherface = otherfaces.begin();
+	     otherface != otherfaces.end(); ++otherface) {
+		if (!is_face_marked(*otherface)) {
+			if (context.count_probes)
+				num_probes += otherface - otherfaces.begin() + 1;
+			return *otherface;
 		}
 	}
-	return MFacePtr();
+	if (context.count_probes) num_probes += otherfaces.size();
+	return -1;
 }
 
-int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
+int TriangleStrip::traverse_faces(int start_vertex, int start_face,
                                   bool forward)
 {
 	int count = 0;
 	int pv0 = start_vertex;
-	int pv1 = start_face->get_next_vertex(pv0);
-	int pv2 = start_face->get_next_vertex(pv1);
+	int pv1 = mesh.faces[start_face].get_next_vertex(pv0);
+	int pv2 = mesh.faces[start_face].get_next_vertex(pv1);
 #ifdef DEBUG
 	// XXX debug
 	std::cout << "starting traversal from " << pv0 << ", " << pv1 << ", " << pv2 << std::endl;
 #endif
-	MFacePtr next_face = get_unmarked_adjacent_face(start_face, pv0);
-	while (next_face) {
+	int next_face = get_unmarked_adjacent_face(start_face, pv0);
+	while (next_face != -1) {
+		// stop at the strip length cap
+		if (context.max_strip_faces
+		    && (faces.size() >= std::size_t(context.max_strip_faces)))
+			break;
 		// XXX the nvidia stripifier says the following:
 		// XXX
 		// XXX   this tests to see if a face is "unique",
@@ -142,7 +178,7 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 				//   / \ /   becomes   / \ /
 				// pv0-pv2            x--pv2
 				pv0 = pv1;
-				pv1 = next_face->get_next_vertex(pv0);
+				pv1 = mesh.faces[next_face].get_next_vertex(pv0);
 				vertices.push_back(pv1);
 				faces.push_back(next_face);
 			} else {
@@ -150,7 +186,7 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 				//  \ / \   becomes   \ / \
 				//  pv1-pv0           pv1--x
 				pv0 = pv2;
-				pv2 = next_face->get_next_vertex(pv1);
+				pv2 = mesh.faces[next_face].get_next_vertex(pv1);
 				vertices.push_front(pv2);
 				reversed = !reversed; // swap winding
 				faces.push_front(next_face);
@@ -161,7 +197,7 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 				//  / \ / \   becomes  / \ / \
 				// x--pv2--x          x--pv0-pv2
 				pv0 = pv2;
-				pv2 = next_face->get_next_vertex(pv1);
+				pv2 = mesh.faces[next_face].get_next_vertex(pv1);
 				vertices.push_back(pv2);
 				faces.push_back(next_face);
 			} else {
@@ -169,7 +205,7 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 				//  / \ / \   becomes   / \ / \
 				// x--pv1--x          pv1-pv0--x
 				pv0 = pv1;
-				pv1 = next_face->get_next_vertex(pv0);
+				pv1 = mesh.faces[next_face].get_next_vertex(pv0);
 				vertices.push_front(pv1);
 				reversed = !reversed; // swap winding
 				faces.push_front(next_face);
@@ -178,11 +214,11 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 #ifdef DEBUG
 		// XXX debug
 		std::cout << " traversing face " << pv0 << ", " << pv1 << ", " << pv2 << std::endl;
-		if (pv1 != next_face->get_next_vertex(pv0))
+		if (pv1 != mesh.faces[next_face].get_next_vertex(pv0))
 			throw std::runtime_error("Traversal bug.");
-		if (pv2 != next_face->get_next_vertex(pv1))
+		if (pv2 != mesh.faces[next_face].get_next_vertex(pv1))
 			throw std::runtime_error("Traversal bug.");
-		if (pv0 != next_face->get_next_vertex(pv2))
+		if (pv0 != mesh.faces[next_face].get_next_vertex(pv2))
 			throw std::runtime_error("Traversal bug.");
 #endif
 		// get next face opposite pv0
@@ -191,15 +227,15 @@ int TriangleStrip::traverse_faces(int start_vertex, MFacePtr start_face,
 	return count;
 };
 
-int TriangleStrip::build(int start_vertex, MFacePtr start_face)
+int TriangleStrip::build(int start_vertex, int start_face)
 {
 	faces.clear();
 	vertices.clear();
 	reversed = false;
 	// find start indices
 	int v0 = start_vertex;
-	int v1 = start_face->get_next_vertex(v0);
-	int v2 = start_face->get_next_vertex(v1);
+	int v1 = mesh.faces[start_face].get_next_vertex(v0);
+	int v2 = mesh.faces[start_face].get_next_vertex(v1);
 	// mark start face and add it to faces and strip
 	mark_face(start_face);
 	faces.push_back(start_face);
@@ -215,65 +251,85 @@ void TriangleStrip::commit()
 {
 	// remove experiment tag from strip and from its faces
 	experiment_id = -1;
-	BOOST_FOREACH(MFacePtr face, faces) mark_face(face);
+	strip_id = context.num_strips++;
+	BOOST_FOREACH(int face, faces) mark_face(face);
+	context.num_free_faces -= faces.size();
+	if (context.cache_size) {
+		BOOST_FOREACH(int vertex, get_strip()) context.cache.add(vertex);
+	};
 };
 
 std::deque<int> TriangleStrip::get_strip()
 {
-	std::deque<int> result;
-	if (reversed) {
-		if (vertices.size() & 1) {
-			// odd length: change winding by reversing
-			// reverse is established through front_inserter
-			std::copy(vertices.begin(), vertices.end(),
-			          std::front_inserter(result));
-		} else if (vertices.size() == 4) {
-			// length 4: we can change winding without
-			// appending a vertex
-			result.push_back(vertices[0]);
-			result.push_back(vertices[2]);
-			result.push_back(vertices[1]);
-			result.push_back(vertices[3]);
-		} else {
-			// all other cases: append duplicate vertex to
-			// front
-			std::copy(vertices.begin(), vertices.end(),
-			          std::back_inserter(result));
-			result.push_front(vertices.front());
-		};
-	} else {
-		std::copy(vertices.begin(), vertices.end(),
-		          std::back_inserter(result));
-	};
+	std::deque<int> result(get_strip_size());
+	copy_strip(result.begin());
 	return result;
 }
 
-int TriangleStrip::NUM_STRIPS = 0;
+std::size_t TriangleStrip::get_strip_size() const
+{
+	if (reversed && !(vertices.size() & 1) && (vertices.size() != 4)) {
+		// duplicate vertex in front
+		return vertices.size() + 1;
+	};
+	return vertices.size();
+}
 
-Experiment::Experiment(int _vertex, MFacePtr _face)
-	: vertex(_vertex), face(_face),
-	  experiment_id(Experiment::NUM_EXPERIMENTS++) {};
+std::list<std::deque<int> > TriangleStrip::get_split_strip()
+{
+	std::list<std::deque<int> > result;
+	if (reversed && !(vertices.size() & 1) && (vertices.size() != 4)) {
+		// first face, with its winding changed
+		result.push_back(std::deque<int>());
+		result.back().push_back(vertices[0]);
+		result.back().push_back(vertices[2]);
+		result.back().push_back(vertices[1]);
+		// remaining faces are shifted by one, which changes their
+		// winding
+		result.push_back(std::deque<int>(vertices.begin() + 1, vertices.end()));
+	} else {
+		result.push_back(get_strip());
+	};
+	return result;
+}
 
-void Experiment::build()
+Experiment::Experiment(StripifierContext & _context, int _vertex, int _face,
+                       std::pmr::memory_resource *_resource)
+	: context(_context), resource(_resource), strips(_resource),
+	  vertex(_vertex), face(_face),
+	  experiment_id(_context.num_experiments++),
+	  num_faces(0), num_misses(0), cache(_context.cache, _resource),
+	  aborted(false), keep_building(0) {};
+
+Experiment::Experiment(StripifierContext & _context, int _vertex, int _face, int _experiment_id,
+                       std::pmr::memory_resource *_resource)
+	: context(_context), resource(_resource), strips(_resource),
+	  vertex(_vertex), face(_face), experiment_id(_experiment_id),
+	  num_faces(0), num_misses(0), cache(_context.cache, _resource),
+	  aborted(false), keep_building(0) {};
+
+void Experiment::build(ExperimentMarks & marks, const Predicate & _keep_building)
 {
+	keep_building = _keep_building ? &_keep_building : 0;
 	// build initial strip
-	TriangleStripPtr strip(new TriangleStrip(experiment_id));
+	TriangleStripPtr strip = allocate_shared<TriangleStrip>(resource, context, marks,
+	                         experiment_id, resource);
 	strip->build(vertex, face);
-	strips.push_back(strip);
+	if (!add_strip(strip)) return;
 	// build strips adjacent to the initial strip, from both sides
 	int num_faces = strip->faces.size();
 	if (num_faces >= 4) {
 		build_adjacent(strip, num_faces / 2);
-		build_adjacent(strip, num_faces / 2 + 1);
+		if (!aborted) build_adjacent(strip, num_faces / 2 + 1);
 	} else if (num_faces == 3) {
 		// also try second edge from long side of the strip if
 		// first edge fails
 		if (!build_adjacent(strip, 0)) build_adjacent(strip, 2);
-		build_adjacent(strip, 1);
+		if (!aborted) build_adjacent(strip, 1);
 	} else if (num_faces == 2) {
 		// try to find a parallel strip from both sides
 		build_adjacent(strip, 0);
-		build_adjacent(strip, 1);
+		if (!aborted) build_adjacent(strip, 1);
 	} else if (num_faces == 1) {
 		// try to find a parallel strip; note that there are
 		// three directions to build a parallel strip to a
@@ -282,8 +338,25 @@ void Experiment::build()
 		// each edge
 		build_adjacent(strip, 0);
 	}
+	keep_building = 0;
 };
 
+bool Experiment::add_strip(TriangleStripPtr strip)
+{
+	strips.push_back(strip);
+	num_faces += strip->faces.size();
+	if (context.cache_size) {
+		BOOST_FOREACH(int vertex, strip->get_strip()) {
+			if (!cache.add(vertex)) num_misses++;
+		};
+	};
+	if (keep_building && !(*keep_building)(*this)) {
+		aborted = true;
+		keep_building = 0;
+	};
+	return !aborted;
+}
+
 bool Experiment::build_adjacent(TriangleStripPtr strip, int face_index)
 {
 	//               zzzzzzzzzzzzzz
@@ -301,12 +374,14 @@ bool Experiment::build_adjacent(TriangleStripPtr strip, int face_index)
 	// and so on...
 
 	int oppositevertex = strip->vertices[face_index + 1];
-	MFacePtr face = strip->faces[face_index];
-	if (MFacePtr otherface = strip->get_unmarked_adjacent_face(face, oppositevertex)) {
+	int face = strip->faces[face_index];
+	int otherface = strip->get_unmarked_adjacent_face(face, oppositevertex);
+	if (otherface != -1) {
 		bool winding = strip->reversed; // winding of first face
 		if (face_index & 1) winding = !winding;
 		// create and build new strip
-		TriangleStripPtr otherstrip(new TriangleStrip(experiment_id));
+		TriangleStripPtr otherstrip = allocate_shared<TriangleStrip>(resource, context, strip->marks,
+		                              experiment_id, resource);
 		if (winding) {
 			int othervertex = strip->vertices[face_index];
 			face_index = otherstrip->build(othervertex, otherface);
@@ -314,7 +389,7 @@ bool Experiment::build_adjacent(TriangleStripPtr strip, int face_index)
 			int nextvertex = strip->vertices[face_index + 2];
 			face_index = otherstrip->build(nextvertex, otherface);
 		};
-		strips.push_back(otherstrip);
+		if (!add_strip(otherstrip)) return true;
 		// build adjacent strip to the strip we just found
 		if (face_index > otherstrip->faces.size() / 2) {
 			build_adjacent(otherstrip, face_index - 1);
@@ -327,36 +402,79 @@ bool Experiment::build_adjacent(TriangleStripPtr strip, int face_index)
 	return false;
 }
 
-int Experiment::NUM_EXPERIMENTS = 0;
-
 ExperimentSelector::ExperimentSelector(int _num_samples, int _min_strip_length)
 	: num_samples(_num_samples), min_strip_length(_min_strip_length),
 	  strip_len_heuristic(1.0), best_score(0.0), best_sample() {};
 
 void ExperimentSelector::update_score(ExperimentPtr experiment)
 {
-	// score is average number of faces per strip
-	// XXX experiment with other scoring rules?
-	int stripsize = 0;
-	BOOST_FOREACH(TriangleStripPtr strip, experiment->strips) {
-		stripsize += strip->faces.size();
-	};
-	float score = ((strip_len_heuristic * stripsize)
-	               / experiment->strips.size());
+	// an aborted experiment cannot beat the best one
+	if (experiment->aborted) return;
+	float score = get_score(*experiment);
 	if (score > best_score) {
 		best_score = score;
 		best_sample = experiment;
 	};
 }
 
+float ExperimentSelector::get_score(const Experiment & experiment) const
+{
+	// score is average number of faces per strip
+	// XXX experiment with other scoring rules?
+	// in cache aware mode, it is number of faces per cache miss,
+	// drawing the strips right after the committed ones
+	int num_misses = experiment.strips.size() + experiment.num_misses;
+	return (strip_len_heuristic * experiment.num_faces) / num_misses;
+}
+
+float ExperimentSelector::get_max_score(const Experiment & experiment) const
+{
+	// note: every bound is computed with the same float operations
+	// as the score, so rounding cannot make it smaller
+	int num_misses = experiment.strips.size() + experiment.num_misses;
+	float max_score = (strip_len_heuristic * experiment.num_faces) / num_misses;
+	int num_free_faces = experiment.context.num_free_faces - experiment.num_faces;
+	if (num_free_faces <= 0) return max_score;
+	// adding k more strips, with at most max_strip_faces faces
+	// each, the score is highest for k = 0, or for the largest k
+	// with full strips, or for the smallest k with all free faces
+	int max_strip_faces = experiment.context.max_strip_faces
+	                      ? experiment.context.max_strip_faces : num_free_faces;
+	int num_full_strips = num_free_faces / max_strip_faces;
+	if (num_full_strips > 0) {
+		max_score = std::max(max_score,
+		                     (strip_len_heuristic
+		                      * (experiment.num_faces + num_full_strips * max_strip_faces))
+		                     / (num_misses + num_full_strips));
+	};
+	int num_strips = (num_free_faces + max_strip_faces - 1) / max_strip_faces;
+	return std::max(max_score,
+	                (strip_len_heuristic * (experiment.num_faces + num_free_faces))
+	                / (num_misses + num_strips));
+}
+
 void ExperimentSelector::clear()
 {
 	best_score = 0.0;
 	best_sample.reset();
 }
 
-TriangleStripifier::TriangleStripifier(MeshPtr _mesh)
-	: selector(10, 0), mesh(_mesh), start_face_iter(_mesh->faces.end()) {};
+//! Size of the initial buffer of each arena of a stripifier.
+static const std::size_t ARENA_BUFFER_SIZE = 256 * 1024;
+
+TriangleStripifier::TriangleStripifier(MeshPtr _mesh, int num_threads, int cache_size,
+                                       std::pmr::memory_resource *resource)
+	: selector(10, 0), mesh(_mesh), start_face(_mesh->faces.size()),
+	  pool(num_threads), context(*_mesh, pool.size(), cache_size, resource),
+	  arenas(), arena_buffers(pool.size(), std::vector<char>(ARENA_BUFFER_SIZE)),
+	  num_rounds(0), reset_point_round(_mesh->faces.size(), -1), stats(0)
+{
+	mesh->lock();
+	for (int worker = 0; worker < pool.size(); worker++) {
+		arenas.emplace_back(new std::pmr::monotonic_buffer_resource(
+		                        arena_buffers[worker].data(), ARENA_BUFFER_SIZE, resource));
+	};
+};
 
 bool TriangleStripifier::find_good_reset_point()
 {
@@ -364,78 +482,144 @@ bool TriangleStripifier::find_good_reset_point()
 	if (mesh->faces.size() == 0)
 		return false;
 
-	int start_step = mesh->faces.size() / selector.num_samples;
-	if ((mesh->faces.end() - start_face_iter) > start_step) {
-		start_face_iter += start_step;
+	int num_faces = mesh->faces.size();
+	int start_step = num_faces / selector.num_samples;
+	if ((num_faces - start_face) > start_step) {
+		start_face += start_step;
 	} else {
-		start_face_iter = mesh->faces.begin() + (start_step - (mesh->faces.end() - start_face_iter));
+		start_face = start_step - (num_faces - start_face);
 	};
-	std::vector<MFacePtr>::const_iterator face = start_face_iter;
-	do {
-		if ((*face)->strip_id == -1) {
-			// face not used in any strip, so start there for next strip
-			start_face_iter = face;
-			return true;
-		};
-		face++;
-		if (face == mesh->faces.end())
-			face = mesh->faces.begin();
-	} while (face != start_face_iter);
-	// we have exhausted all the faces
-	return false;
+	// first face not used in any strip, from start_face onwards,
+	// wrapping around at the end
+	int face = context.free_faces.find_next(start_face);
+	if (face == num_faces) face = context.free_faces.find_next(0);
+	if (face == num_faces) {
+		// we have exhausted all the faces
+		return false;
+	};
+	if (stats) {
+		stats->num_reset_points++;
+		stats->num_reset_point_skips += (face >= start_face)
+		                                ? face - start_face
+		                                : num_faces - start_face + face;
+	};
+	// start there for next strip
+	start_face = face;
+	return true;
 };
 
+typedef std::chrono::steady_clock Clock;
+
+//! Add the time since start to seconds, and restart from now.
+static void add_seconds(double & seconds, Clock::time_point & start)
+{
+	Clock::time_point now = Clock::now();
+	seconds += std::chrono::duration<double>(now - start).count();
+	start = now;
+}
+
 std::list<TriangleStripPtr> TriangleStripifier::find_all_strips()
 {
 	std::list<TriangleStripPtr> all_strips;
+	Clock::time_point start;
+	if (stats) start = Clock::now();
+	context.count_probes = (stats != 0);
 
 	while (true) {
-		// note: one experiment is a collection of adjacent strips
-		std::list<ExperimentPtr> experiments;
-		std::set<Face> visited_reset_points;
+		// note: one experiment is a collection of adjacent strips;
+		// all experiments of the round live in the arenas, the
+		// list of seeds and experiments in the first one
+		std::pmr::vector<std::pair<int, int> > seeds(arenas[0].get());
+		num_rounds++;
 		for (int n_sample = 0; n_sample < selector.num_samples; n_sample++) {
 			// Get a good start face for an experiment
 			if (!find_good_reset_point()) {
 				// done!
 				break;
 			};
-			MFacePtr exp_face = *start_face_iter;
-			// XXX this is an ugly pointer hack...
-			// XXX do we need to check this?
-			Face *exp_face_index = dynamic_cast<Face *>(&(**start_face_iter));
-			if (visited_reset_points.find(*exp_face_index) != visited_reset_points.end()) {
+			int exp_face = start_face;
+			if (reset_point_round[exp_face] == num_rounds) {
 				// We've seen this face already... try again
 				continue;
 			}
-			visited_reset_points.insert(*exp_face_index);
+			reset_point_round[exp_face] = num_rounds;
 			// Create an exploration from ExpFace in each of the three directions
-			int vertices[] = {exp_face->v0, exp_face->v1, exp_face->v2};
+			const Face & f = mesh->faces[exp_face];
+			int vertices[] = {f.v0, f.v1, f.v2};
 			BOOST_FOREACH(int exp_vertex, vertices) {
-				// Create the seed strip for the experiment
-				ExperimentPtr exp(new Experiment(exp_vertex, exp_face));
-				// Add the seeded experiment list to the experiment collection
-				experiments.push_back(exp);
+				seeds.push_back(std::make_pair(exp_vertex, exp_face));
 			}
 		}
-		if (experiments.empty()) {
+		if (stats) add_seconds(stats->reset_point_seconds, start);
+		if (seeds.empty()) {
 			// no more experiments to run: done!!
 			return all_strips;
 		};
+		// create and build all experiments, in parallel, each in
+		// the arena of its thread
+		std::pmr::vector<ExperimentPtr> experiments(seeds.size(), arenas[0].get());
+		int first_experiment_id = context.num_experiments;
+		context.num_experiments += seeds.size();
+		// best score of the experiments built so far: others are
+		// aborted as soon as they cannot beat it anymore, which
+		// does not change the selected experiment
+		std::atomic<float> best_score(0.0);
+		Experiment::Predicate can_win = [&](const Experiment & experiment) {
+			return selector.get_max_score(experiment) >= best_score.load(std::memory_order_relaxed);
+		};
+		pool.run(experiments.size(), [&](int i, int worker) {
+			std::pmr::memory_resource *arena = arenas[worker].get();
+			experiments[i] = allocate_shared<Experiment>(arena, context, seeds[i].first,
+			                 seeds[i].second, first_experiment_id + i, arena);
+			experiments[i]->build(context.marks[worker], can_win);
+			if (experiments[i]->aborted) return;
+			float score = selector.get_score(*experiments[i]);
+			float old_score = best_score.load(std::memory_order_relaxed);
+			while ((score > old_score)
+			       && !best_score.compare_exchange_weak(old_score, score, std::memory_order_relaxed));
+		});
+		if (stats) add_seconds(stats->experiment_seconds, start);
+		// score them in order, so the selected experiment does
+		// not depend on the number of threads
 		// note: iterate via reference, so we can clear the experiment
 		BOOST_FOREACH(ExperimentPtr & exp, experiments) {
-			exp->build();
+			if (stats) {
+				stats->num_experiments++;
+				if (exp->aborted) stats->num_aborted_experiments++;
+				// all faces but the first of each strip are
+				// added by traverse_faces
+				stats->num_traversed_faces += exp->num_faces - exp->strips.size();
+				BOOST_FOREACH(const TriangleStripPtr & strip, exp->strips) {
+					stats->num_adjacency_probes += strip->num_probes;
+				};
+			};
 			selector.update_score(exp);
 			exp.reset(); // no reason to keep
 		};
-		experiments.clear(); // no reason to keep
 		// Get the best experiment according to the selector
 		ExperimentPtr best_experiment = selector.best_sample;
 		selector.clear();
-		// And commit it to the resultset
+		// And commit a copy of it, outside the arenas, to the
+		// resultset
 		BOOST_FOREACH(TriangleStripPtr strip, best_experiment->strips) {
-			strip->commit();
-			all_strips.push_back(strip);
+			TriangleStripPtr committed = allocate_shared<TriangleStrip>(
+			                                 context.resource, *strip, context.resource);
+			committed->commit();
+			if (stats) stats->add_strip(committed->faces.size());
+			all_strips.push_back(committed);
 		}
 		best_experiment.reset();
+		// all objects in the arenas are gone, so reuse them
+		experiments.clear();
+		experiments.shrink_to_fit();
+		seeds.clear();
+		seeds.shrink_to_fit();
+		BOOST_FOREACH(std::unique_ptr<std::pmr::monotonic_buffer_resource> & arena, arenas) {
+			arena->release();
+		};
+		if (stats) {
+			stats->num_rounds++;
+			add_seconds(stats->commit_seconds, start);
+		};
 	}
 }
@@ -35,34 +35,274 @@ POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 #include <boost/foreach.hpp>
 
+#include "stripstitcher.hpp"
+#include "threadpool.hpp"
 #include "tristrip.hpp"
+#include "trianglelistoptimizer.hpp"
 #include "trianglestripifier.hpp"
 
-std::list<std::deque<int> > stripify(const std::list<std::list<int> > & triangles)
+//! Stripify mesh, or optimize it as triangle list, as set in
+//! options. The indices of all strips are appended to strip_indices,
+//! and their lengths to strip_lengths. Index is the type of the
+//! output indices, which also determines the restart index.
+template <typename Index>
+static void stripify_mesh(MeshPtr mesh, const StripifyOptions & options,
+                          std::vector<Index> & strip_indices,
+                          std::vector<std::size_t> & strip_lengths)
+{
+	if (options.output == OUTPUT_TRIANGLE_LIST) {
+		TriangleListOptimizer t(mesh, options.cache_size
+		                        ? options.cache_size
+		                        : TriangleListOptimizer::DEFAULT_CACHE_SIZE);
+		std::size_t first = strip_indices.size();
+		BOOST_FOREACH(int face, t.find_face_order()) {
+			strip_indices.push_back(mesh->faces[face].v0);
+			strip_indices.push_back(mesh->faces[face].v1);
+			strip_indices.push_back(mesh->faces[face].v2);
+		};
+		if (strip_indices.size() > first)
+			strip_lengths.push_back(strip_indices.size() - first);
+		return;
+	};
+	if (options.num_samples < 1)
+		throw std::runtime_error("Number of samples must be positive.");
+	TriangleStripifier t(mesh, options.num_threads, options.cache_size,
+	                     options.resource ? options.resource
+	                     : std::pmr::get_default_resource());
+	t.selector.num_samples = options.num_samples;
+	t.stats = options.stats;
+	std::list<TriangleStripPtr> strips = t.find_all_strips();
+	if (options.output == OUTPUT_STITCHED_STRIP) {
+		std::vector<std::deque<int> > vertices;
+		vertices.reserve(strips.size());
+		BOOST_FOREACH(TriangleStripPtr strip, strips) {
+			vertices.push_back(strip->get_strip());
+		};
+		if (vertices.empty()) return;
+		std::deque<int> stitched = stitch_strips(vertices);
+		strip_indices.insert(strip_indices.end(), stitched.begin(), stitched.end());
+		strip_lengths.push_back(stitched.size());
+		return;
+	};
+	if (options.output == OUTPUT_RESTART_STRIP) {
+		int restart_index = Index(options.restart_index);
+		BOOST_FOREACH(const Face & face, mesh->faces) {
+			if ((face.v0 == restart_index) || (face.v1 == restart_index)
+			    || (face.v2 == restart_index))
+				throw std::runtime_error("Vertex index equals restart index.");
+		};
+		std::size_t first = strip_indices.size();
+		BOOST_FOREACH(TriangleStripPtr strip, strips) {
+			BOOST_FOREACH(const std::deque<int> & vertices, strip->get_split_strip()) {
+				if (strip_indices.size() > first) strip_indices.push_back(restart_index);
+				strip_indices.insert(strip_indices.end(), vertices.begin(), vertices.end());
+			};
+		};
+		if (strip_indices.size() > first)
+			strip_lengths.push_back(strip_indices.size() - first);
+		return;
+	};
+	// copy each strip straight into the output
+	std::size_t size = strip_indices.size();
+	BOOST_FOREACH(TriangleStripPtr strip, strips) {
+		size += strip->get_strip_size();
+	};
+	strip_indices.reserve(size);
+	BOOST_FOREACH(TriangleStripPtr strip, strips) {
+		std::size_t first = strip_indices.size();
+		strip_indices.resize(first + strip->get_strip_size());
+		strip->copy_strip(strip_indices.begin() + first);
+		strip_lengths.push_back(strip_indices.size() - first);
+	};
+}
+
+std::list<std::deque<int> > stripify(const std::list<std::list<int> > & triangles,
+                                     const StripifyOptions & options)
 {
 	// build mesh
-	MeshPtr mesh(new Mesh);
-	BOOST_FOREACH(std::list<int> triangle, triangles) {
+	std::vector<int> indices;
+	indices.reserve(3 * triangles.size());
+	BOOST_FOREACH(const std::list<int> & triangle, triangles) {
 		std::list<int>::const_iterator vertex = triangle.begin();
 		assert(vertex != triangle.end());
-		int v0 = *vertex++;
+		indices.push_back(*vertex++);
 		assert(vertex != triangle.end());
-		int v1 = *vertex++;
+		indices.push_back(*vertex++);
 		assert(vertex != triangle.end());
-		int v2 = *vertex++;
+		indices.push_back(*vertex++);
 		assert(vertex == triangle.end());
-		if ((v0 != v1) && (v1 != v2) && (v2 != v0))
-			mesh->add_face(v0, v1, v2);
 	};
-	// stripify the mesh
-	TriangleStripifier t(mesh);
-	std::list<TriangleStripPtr> strips = t.find_all_strips();
-	// extract and return triangle strips
+	MeshPtr mesh(new Mesh(indices.data(), triangles.size(), options.stats));
+	// stripify the mesh, and return triangle strips
+	std::vector<int> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify_mesh(mesh, options, strip_indices, strip_lengths);
 	std::list<std::deque<int> > result;
-	BOOST_FOREACH(TriangleStripPtr strip, strips) {
-		result.push_back(strip->get_strip());
+	std::vector<int>::const_iterator strip = strip_indices.begin();
+	BOOST_FOREACH(std::size_t length, strip_lengths) {
+		result.push_back(std::deque<int>(strip, strip + length));
+		strip += length;
 	};
 	return result;
 };
+
+template <typename Index>
+static void stripify_buffer(const Index *indices, std::size_t num_triangles,
+                            std::vector<Index> & strip_indices,
+                            std::vector<std::size_t> & strip_lengths,
+                            const StripifyOptions & options)
+{
+	strip_indices.clear();
+	strip_lengths.clear();
+	// build mesh directly from the buffer, and stripify it
+	MeshPtr mesh(new Mesh(indices, num_triangles, options.stats));
+	stripify_mesh(mesh, options, strip_indices, strip_lengths);
+}
+
+void stripify(const boost::uint16_t *indices, std::size_t num_triangles,
+              std::vector<boost::uint16_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options)
+{
+	stripify_buffer(indices, num_triangles, strip_indices, strip_lengths, options);
+}
+
+void stripify(const boost::uint32_t *indices, std::size_t num_triangles,
+              std::vector<boost::uint32_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options)
+{
+	stripify_buffer(indices, num_triangles, strip_indices, strip_lengths, options);
+}
+
+void stripify(MeshPtr mesh,
+              std::vector<boost::uint32_t> & strip_indices,
+              std::vector<std::size_t> & strip_lengths,
+              const StripifyOptions & options)
+{
+	strip_indices.clear();
+	strip_lengths.clear();
+	stripify_mesh(mesh, options, strip_indices, strip_lengths);
+}
+
+//! Part of a mesh in stripify_batch: a range of its triangles.
+struct BatchPart {
+	std::size_t mesh;
+	std::size_t first_triangle;
+	std::size_t num_triangles;
+	//! Index in the list of strips of split meshes, or -1 if this
+	//! part is a whole mesh.
+	int split_index;
+};
+
+//! Sort parts by decreasing size.
+static bool batch_part_larger(const BatchPart & part, const BatchPart & otherpart)
+{
+	return part.num_triangles > otherpart.num_triangles;
+}
+
+//! Minimal number of triangles of a task in stripify_batch, small
+//! meshes are grouped until they reach this size.
+static const std::size_t BATCH_MIN_TASK_TRIANGLES = 4096;
+
+void stripify_batch(const std::vector<BatchMesh> & meshes,
+                    std::vector<BatchStrips> & strips,
+                    int num_threads, std::size_t max_triangles,
+                    const StripifyOptions & options)
+{
+	strips.clear();
+	strips.resize(meshes.size());
+	// cut meshes into parts
+	std::vector<BatchPart> parts;
+	std::vector<BatchStrips> split_strips;
+	for (std::size_t mesh = 0; mesh < meshes.size(); mesh++) {
+		std::size_t num_triangles = meshes[mesh].num_triangles;
+		if ((max_triangles == 0) || (num_triangles <= max_triangles)) {
+			BatchPart part = {mesh, 0, num_triangles, -1};
+			parts.push_back(part);
+			continue;
+		}
+		for (std::size_t first = 0; first < num_triangles; first += max_triangles) {
+			BatchPart part = {
+				mesh, first, std::min(max_triangles, num_triangles - first),
+				int(split_strips.size())
+			};
+			parts.push_back(part);
+			split_strips.push_back(BatchStrips());
+		}
+	}
+	// large parts first, and group small parts into tasks
+	std::stable_sort(parts.begin(), parts.end(), batch_part_larger);
+	std::vector<std::size_t> task_offsets(1, 0);
+	std::size_t task_triangles = 0;
+	for (std::size_t i = 0; i < parts.size(); i++) {
+		task_triangles += parts[i].num_triangles;
+		if ((task_triangles >= BATCH_MIN_TASK_TRIANGLES) || (i + 1 == parts.size())) {
+			task_offsets.push_back(i + 1);
+			task_triangles = 0;
+		}
+	}
+	// stripify all parts, each on a single thread, with stats for
+	// each thread
+	StripifyOptions part_options(options);
+	part_options.num_threads = 1;
+	ThreadPool pool(num_threads);
+	std::vector<StripifyStats> worker_stats(options.stats ? pool.size() : 0);
+	pool.run(task_offsets.size() - 1, [&](int task, int worker) {
+		StripifyOptions worker_options(part_options);
+		if (options.stats) worker_options.stats = &worker_stats[worker];
+		for (std::size_t i = task_offsets[task]; i < task_offsets[task + 1]; i++) {
+			const BatchPart & part = parts[i];
+			BatchStrips & part_strips = (part.split_index == -1)
+			                            ? strips[part.mesh]
+			                            : split_strips[part.split_index];
+			stripify_buffer(meshes[part.mesh].indices + 3 * part.first_triangle,
+			                part.num_triangles,
+			                part_strips.indices, part_strips.lengths,
+			                worker_options);
+		}
+	});
+	BOOST_FOREACH(const StripifyStats & stats, worker_stats) options.stats->add(stats);
+	// join strips of parts, in order
+	std::size_t split_index = 0;
+	for (std::size_t mesh = 0; mesh < meshes.size(); mesh++) {
+		std::size_t num_triangles = meshes[mesh].num_triangles;
+		if ((max_triangles == 0) || (num_triangles <= max_triangles))
+			continue;
+		BatchStrips & mesh_strips = strips[mesh];
+		for (std::size_t first = 0; first < num_triangles; first += max_triangles) {
+			BatchStrips & part_strips = split_strips[split_index++];
+			if ((options.output == OUTPUT_STRIPS) || mesh_strips.indices.empty()) {
+				mesh_strips.indices.insert(mesh_strips.indices.end(),
+				                           part_strips.indices.begin(),
+				                           part_strips.indices.end());
+				mesh_strips.lengths.insert(mesh_strips.lengths.end(),
+				                           part_strips.lengths.begin(),
+				                           part_strips.lengths.end());
+				continue;
+			}
+			if (part_strips.indices.empty())
+				continue;
+			// append part to the single strip of the mesh
+			if (options.output == OUTPUT_STITCHED_STRIP) {
+				std::deque<int> part(part_strips.indices.begin(), part_strips.indices.end());
+				BOOST_FOREACH(int index, get_stitch_indices(mesh_strips.indices.size(),
+				              mesh_strips.indices.back(), part)) {
+					mesh_strips.indices.push_back(index);
+				}
+			} else if (options.output == OUTPUT_RESTART_STRIP) {
+				mesh_strips.indices.push_back(options.restart_index);
+			}
+			mesh_strips.indices.insert(mesh_strips.indices.end(),
+			                           part_strips.indices.begin(),
+			                           part_strips.indices.end());
+			mesh_strips.lengths.back() = mesh_strips.indices.size();
+		}
+	}
+}
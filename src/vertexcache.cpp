@@ -0,0 +1,93 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm> // std::swap
+
+#include "vertexcache.hpp"
+
+VertexCache::VertexCache(int size, CachePolicy _policy, std::pmr::memory_resource *resource)
+	: policy(_policy), entries(size > 0 ? size : 1, resource), next(0), num_entries(0) {};
+
+VertexCache::VertexCache(const VertexCache & cache, std::pmr::memory_resource *resource)
+	: policy(cache.policy), entries(cache.entries, resource), next(cache.next),
+	  num_entries(cache.num_entries) {};
+
+int VertexCache::size() const
+{
+	return entries.size();
+}
+
+int VertexCache::find(int vertex) const
+{
+	for (int i = 0; i < num_entries; i++) {
+		if (entries[i] == vertex) return i;
+	}
+	return -1;
+}
+
+bool VertexCache::contains(int vertex) const
+{
+	return find(vertex) != -1;
+}
+
+bool VertexCache::add(int vertex)
+{
+	int i = find(vertex);
+	if (i != -1) {
+		if (policy == CACHE_LRU) {
+			// move vertex to the back of the line: rotate the
+			// ring buffer, from i up to the newest entry
+			int newest = (next + entries.size() - 1) % entries.size();
+			while (i != newest) {
+				int j = (i + 1) % entries.size();
+				std::swap(entries[i], entries[j]);
+				i = j;
+			}
+		}
+		return true;
+	}
+	entries[next] = vertex;
+	next = (next + 1) % entries.size();
+	if (num_entries < int(entries.size())) num_entries++;
+	return false;
+}
+
+void VertexCache::clear()
+{
+	next = 0;
+	num_entries = 0;
+}
@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "bitset.hpp"
+
+//! Index of first true value at or after i, or size.
+static std::size_t find_next(const std::vector<bool> & bits, std::size_t i)
+{
+	while ((i < bits.size()) && !bits[i]) i++;
+	return (i < bits.size()) ? i : bits.size();
+}
+
+BOOST_AUTO_TEST_SUITE(bitset_test_suite)
+
+BOOST_AUTO_TEST_CASE(bitset_count_trailing_zeros_test)
+{
+	BOOST_CHECK_EQUAL(count_trailing_zeros(1), 0);
+	BOOST_CHECK_EQUAL(count_trailing_zeros(12), 2);
+	BOOST_CHECK_EQUAL(count_trailing_zeros(boost::uint64_t(1) << 63), 63);
+}
+
+BOOST_AUTO_TEST_CASE(bitset_find_next_test)
+{
+	// compare against a vector, for sizes around word and summary
+	// word boundaries, while clearing bits
+	std::size_t sizes[] = {0, 1, 63, 64, 65, 4095, 4096, 4097, 10000};
+	for (std::size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+		std::size_t size = sizes[n];
+		BitSet b(size, true);
+		std::vector<bool> v(size, true);
+		BOOST_CHECK_EQUAL(b.size(), size);
+		std::size_t step = 1;
+		while (true) {
+			for (std::size_t i = 0; i <= size; i += 1 + i / 7) {
+				BOOST_CHECK_EQUAL(b.find_next(i), find_next(v, i));
+			}
+			if (find_next(v, 0) == size) break;
+			// clear every step-th set bit
+			for (std::size_t i = find_next(v, 0); i < size; i = find_next(v, i + step)) {
+				b.reset(i);
+				v[i] = false;
+			}
+			step = 2 * step + 1;
+		}
+		BOOST_CHECK_EQUAL(b.find_next(0), size);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bitset_set_test)
+{
+	BitSet b(10000);
+	BOOST_CHECK_EQUAL(b.find_next(0), 10000);
+	b.set(9999);
+	b.set(5000);
+	BOOST_CHECK(b.test(5000));
+	BOOST_CHECK(!b.test(5001));
+	BOOST_CHECK_EQUAL(b.find_next(0), 5000);
+	BOOST_CHECK_EQUAL(b.find_next(5001), 9999);
+	b.reset(5000);
+	BOOST_CHECK_EQUAL(b.find_next(0), 9999);
+	b.reset(9999);
+	BOOST_CHECK_EQUAL(b.find_next(0), 10000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include "cacheanalysis.hpp"
+
+BOOST_AUTO_TEST_SUITE(cache_analysis_test_suite)
+
+BOOST_AUTO_TEST_CASE(analyze_strips_test)
+{
+	// two strips, the second one stitched with a degenerate join
+	int indices[] = {0, 1, 2, 3, 10, 11, 12, 12, 12, 13, 14};
+	std::vector<std::size_t> lengths;
+	lengths.push_back(4);
+	lengths.push_back(7);
+	CacheStats stats = analyze_cache(indices, lengths);
+	BOOST_CHECK_EQUAL(stats.num_indices, 11);
+	BOOST_CHECK_EQUAL(stats.num_triangles, 4);
+	BOOST_CHECK_EQUAL(stats.num_degenerates, 3);
+	BOOST_CHECK_EQUAL(stats.num_restarts, 0);
+	BOOST_CHECK_EQUAL(stats.num_vertices, 9);
+	BOOST_CHECK_EQUAL(stats.num_misses, 9);
+	BOOST_CHECK_CLOSE(stats.acmr, 9.0 / 4, 0.001);
+	BOOST_CHECK_CLOSE(stats.atvr, 1.0, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(analyze_restart_test)
+{
+	boost::uint16_t indices[] = {0, 1, 2, 3, 0xFFFF, 2, 1, 4};
+	std::vector<std::size_t> lengths(1, 8);
+	CacheAnalysisOptions options;
+	options.primitive_restart = true;
+	CacheStats stats = analyze_cache(indices, lengths, options);
+	BOOST_CHECK_EQUAL(stats.num_indices, 8);
+	BOOST_CHECK_EQUAL(stats.num_triangles, 3);
+	BOOST_CHECK_EQUAL(stats.num_degenerates, 0);
+	BOOST_CHECK_EQUAL(stats.num_restarts, 1);
+	BOOST_CHECK_EQUAL(stats.num_vertices, 5);
+	BOOST_CHECK_EQUAL(stats.num_misses, 5);
+}
+
+BOOST_AUTO_TEST_CASE(analyze_list_test)
+{
+	boost::uint32_t indices[] = {0, 1, 2, 2, 1, 3, 4, 5, 6, 7, 7, 8};
+	std::vector<std::size_t> lengths(1, 12);
+	CacheAnalysisOptions options;
+	options.primitive = PRIMITIVE_TRIANGLE_LIST;
+	options.cache_size = 4;
+	CacheStats stats = analyze_cache(indices, lengths, options);
+	BOOST_CHECK_EQUAL(stats.num_triangles, 3);
+	BOOST_CHECK_EQUAL(stats.num_degenerates, 1);
+	BOOST_CHECK_EQUAL(stats.num_vertices, 9);
+	BOOST_CHECK_EQUAL(stats.num_misses, 9);
+	// list must consist of whole triangles
+	lengths[0] = 11;
+	BOOST_CHECK_THROW(analyze_cache(indices, lengths, options), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(analyze_policy_test)
+{
+	// vertex 0 is reused all the time, which only LRU keeps
+	int indices[] = {0, 1, 2, 0, 3, 4, 0, 5, 6, 0, 7, 8};
+	std::vector<std::size_t> lengths(1, 12);
+	CacheAnalysisOptions options;
+	options.primitive = PRIMITIVE_TRIANGLE_LIST;
+	options.cache_size = 3;
+	CacheStats fifo_stats = analyze_cache(indices, lengths, options);
+	BOOST_CHECK_EQUAL(fifo_stats.num_misses, 10);
+	BOOST_CHECK_CLOSE(fifo_stats.atvr, 10.0 / 9, 0.001);
+	options.policy = CACHE_LRU;
+	CacheStats lru_stats = analyze_cache(indices, lengths, options);
+	BOOST_CHECK_EQUAL(lru_stats.num_misses, 9);
+	BOOST_CHECK_CLOSE(lru_stats.acmr, 9.0 / 4, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(analyze_empty_test)
+{
+	std::vector<std::size_t> lengths;
+	CacheStats stats = analyze_cache((const int *)0, lengths);
+	BOOST_CHECK_EQUAL(stats.num_indices, 0);
+	BOOST_CHECK_EQUAL(stats.acmr, 0.0);
+	BOOST_CHECK_EQUAL(stats.atvr, 0.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <boost/foreach.hpp>
+
+#include "clusterizer.hpp"
+#include "testmesh.hpp"
+
+BOOST_AUTO_TEST_SUITE(clusterizer_test_suite)
+
+BOOST_AUTO_TEST_CASE(find_clusters_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(40);
+	Mesh mesh(indices.data(), indices.size() / 3);
+	std::vector<std::vector<int> > clusters = find_clusters(mesh, 32, 40);
+	// every face in exactly one cluster, within the limits
+	std::vector<int> count(mesh.faces.size(), 0);
+	BOOST_FOREACH(const std::vector<int> & cluster, clusters) {
+		BOOST_CHECK(!cluster.empty());
+		BOOST_CHECK_LE(cluster.size(), 40);
+		std::set<int> vertices;
+		BOOST_FOREACH(int face, cluster) {
+			count[face]++;
+			vertices.insert(mesh.faces[face].v0);
+			vertices.insert(mesh.faces[face].v1);
+			vertices.insert(mesh.faces[face].v2);
+		}
+		BOOST_CHECK_LE(vertices.size(), 32);
+	}
+	BOOST_CHECK(std::size_t(std::count(count.begin(), count.end(), 1)) == count.size());
+	// clusters are mostly full
+	BOOST_CHECK_LE(clusters.size(), 2 * mesh.faces.size() / 40);
+	BOOST_CHECK_THROW(find_clusters(mesh, 2, 40), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_clusters_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(40);
+	std::vector<float> positions = grid_positions(40);
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < indices.size(); i += 3)
+		faces.insert(Face(indices[i], indices[i + 1], indices[i + 2]));
+	std::vector<Cluster> clusters;
+	stripify_clusters(indices.data(), indices.size() / 3, positions.data(), clusters);
+	std::set<Face> strip_faces;
+	BOOST_FOREACH(const Cluster & cluster, clusters) {
+		BOOST_CHECK_LE(cluster.vertices.size(), DEFAULT_CLUSTER_VERTICES);
+		BOOST_CHECK_LE(cluster.faces.size(), DEFAULT_CLUSTER_TRIANGLES);
+		// strips only use vertices of the cluster, and cover its faces
+		std::set<Face> cluster_faces;
+		std::vector<boost::uint32_t>::const_iterator i = cluster.strips.indices.begin();
+		BOOST_FOREACH(std::size_t length, cluster.strips.lengths) {
+			triangulate(i, i + length, cluster_faces);
+			i += length;
+		}
+		BOOST_CHECK(i == cluster.strips.indices.end());
+		BOOST_CHECK_EQUAL(cluster_faces.size(), cluster.faces.size());
+		BOOST_FOREACH(boost::uint32_t index, cluster.strips.indices) {
+			BOOST_CHECK(std::find(cluster.vertices.begin(), cluster.vertices.end(), index)
+			            != cluster.vertices.end());
+		}
+		strip_faces.insert(cluster_faces.begin(), cluster_faces.end());
+		// bounds contain all vertices
+		BOOST_FOREACH(int vertex, cluster.vertices) {
+			float d2 = 0;
+			for (int k = 0; k < 3; k++) {
+				float p = positions[3 * vertex + k];
+				BOOST_CHECK(cluster.bounds.min[k] <= p);
+				BOOST_CHECK(p <= cluster.bounds.max[k]);
+				float d = p - cluster.bounds.center[k];
+				d2 += d * d;
+			}
+			BOOST_CHECK(d2 <= cluster.bounds.radius * cluster.bounds.radius * 1.0001f);
+		}
+	}
+	BOOST_CHECK(strip_faces == faces);
+	// same result on any number of threads
+	std::vector<Cluster> other_clusters;
+	stripify_clusters(indices.data(), indices.size() / 3, 0, other_clusters,
+	                  DEFAULT_CLUSTER_VERTICES, DEFAULT_CLUSTER_TRIANGLES, 3);
+	BOOST_REQUIRE_EQUAL(other_clusters.size(), clusters.size());
+	for (std::size_t i = 0; i < clusters.size(); i++) {
+		BOOST_CHECK(other_clusters[i].faces == clusters[i].faces);
+		BOOST_CHECK(other_clusters[i].strips.indices == clusters[i].strips.indices);
+		BOOST_CHECK_EQUAL(other_clusters[i].bounds.radius, 0);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
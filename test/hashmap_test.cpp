@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <boost/foreach.hpp>
+
+#include "hashmap.hpp"
+#include "trianglemesh.hpp"
+
+BOOST_AUTO_TEST_SUITE(hashmap_test_suite)
+
+BOOST_AUTO_TEST_CASE(hashmap_insert_find_test)
+{
+	HashMap<boost::uint64_t, int> h;
+	BOOST_CHECK_EQUAL(h.size(), 0);
+	BOOST_CHECK(h.find(5) == h.end());
+	h[5] = 50;
+	h[7] = 70;
+	BOOST_CHECK_EQUAL(h.size(), 2);
+	BOOST_CHECK_EQUAL(h.find(5)->second, 50);
+	BOOST_CHECK_EQUAL(h.find(7)->second, 70);
+	BOOST_CHECK(h.find(6) == h.end());
+	// existing key does not insert
+	h[5] = 51;
+	BOOST_CHECK_EQUAL(h.size(), 2);
+	BOOST_CHECK_EQUAL(h.find(5)->second, 51);
+	// new key is default initialized
+	BOOST_CHECK_EQUAL(h[9], 0);
+	BOOST_CHECK_EQUAL(h.size(), 3);
+	h.clear();
+	BOOST_CHECK_EQUAL(h.size(), 0);
+	BOOST_CHECK(h.find(5) == h.end());
+}
+
+BOOST_AUTO_TEST_CASE(hashmap_rehash_test)
+{
+	// compare against std::map while the table grows
+	typedef HashMap<boost::uint64_t, int> IntMap;
+	IntMap h;
+	std::map<boost::uint64_t, int> m;
+	for (int i = 0; i < 5000; i++) {
+		boost::uint64_t key = Edge(i % 97, i + 100).key();
+		h[key] = i;
+		m[key] = i;
+	}
+	BOOST_CHECK_EQUAL(h.size(), m.size());
+	int num_iterated = 0;
+	BOOST_FOREACH(const IntMap::Entry & entry, h) {
+		BOOST_CHECK_EQUAL(m[entry.first], entry.second);
+		num_iterated++;
+	}
+	BOOST_CHECK_EQUAL(num_iterated, m.size());
+}
+
+BOOST_AUTO_TEST_CASE(hashmap_reserve_test)
+{
+	HashMap<Face, int, FaceHash> h;
+	h.reserve(1000);
+	for (int i = 0; i < 1000; i++) h[Face(i, i + 1, i + 2)] = i;
+	BOOST_CHECK_EQUAL(h.size(), 1000);
+	// rotated faces compare equal
+	BOOST_CHECK_EQUAL(h.find(Face(12, 10, 11))->second, 10);
+	// opposite winding is another face
+	BOOST_CHECK(h.find(Face(12, 11, 10)) == h.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "indexbuffer.hpp"
+#include "testmesh.hpp"
+
+//! Name of a file in the temporary directory, removed when done.
+class TemporaryFile
+{
+public:
+	std::string name;
+
+	TemporaryFile(const std::string & _name)
+		: name((std::filesystem::temp_directory_path() / _name).string()) {};
+	~TemporaryFile() {
+		std::remove(name.c_str());
+	};
+};
+
+BOOST_AUTO_TEST_SUITE(indexbuffer_test_suite)
+
+BOOST_AUTO_TEST_CASE(index_buffer_file_test)
+{
+	TemporaryFile triangles("indexbuffer_test_triangles.bin");
+	std::vector<boost::uint16_t> indices = grid<boost::uint16_t>(10);
+	write_index_buffer(triangles.name, CONTENT_TRIANGLES, 2, indices.data(), indices.size(),
+	                   std::vector<std::size_t>());
+	IndexBufferFile file(triangles.name);
+	BOOST_CHECK_EQUAL(file.get_header().index_size, 2);
+	BOOST_CHECK_EQUAL(file.get_header().content, CONTENT_TRIANGLES);
+	BOOST_CHECK_EQUAL(file.get_header().num_triangles, 200);
+	BOOST_CHECK_EQUAL(file.get_header().num_indices, 600);
+	BOOST_CHECK(std::equal(indices.begin(), indices.end(), file.get_indices<boost::uint16_t>()));
+	BOOST_CHECK_THROW(file.get_indices<boost::uint32_t>(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_file_test)
+{
+	TemporaryFile triangles("indexbuffer_test_triangles.bin");
+	TemporaryFile strips("indexbuffer_test_strips.bin");
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(20);
+	write_index_buffer(triangles.name, CONTENT_TRIANGLES, 4, indices.data(), indices.size(),
+	                   std::vector<std::size_t>());
+	// same strips as stripify in memory, for every output
+	StripifyOutput outputs[] = {
+		OUTPUT_STRIPS, OUTPUT_STITCHED_STRIP, OUTPUT_RESTART_STRIP, OUTPUT_TRIANGLE_LIST
+	};
+	IndexBufferContent contents[] = {
+		CONTENT_STRIPS, CONTENT_STITCHED_STRIP, CONTENT_RESTART_STRIP, CONTENT_TRIANGLES
+	};
+	for (int i = 0; i < 4; i++) {
+		StripifyOptions options;
+		options.output = outputs[i];
+		stripify_file(triangles.name, strips.name, options);
+		std::vector<boost::uint32_t> strip_indices;
+		std::vector<std::size_t> strip_lengths;
+		stripify(indices.data(), indices.size() / 3, strip_indices, strip_lengths, options);
+		IndexBufferFile file(strips.name);
+		const IndexBufferHeader & header = file.get_header();
+		BOOST_CHECK_EQUAL(header.content, contents[i]);
+		BOOST_CHECK_EQUAL(header.index_size, 4);
+		BOOST_CHECK_EQUAL(header.num_triangles, 800);
+		BOOST_CHECK_EQUAL(header.restart_index, 0xFFFFFFFF);
+		BOOST_REQUIRE_EQUAL(header.num_indices, strip_indices.size());
+		BOOST_CHECK(std::equal(strip_indices.begin(), strip_indices.end(),
+		                       file.get_indices<boost::uint32_t>()));
+		if (contents[i] == CONTENT_STRIPS) {
+			BOOST_REQUIRE_EQUAL(header.num_strips, strip_lengths.size());
+			BOOST_CHECK(std::equal(strip_lengths.begin(), strip_lengths.end(), file.get_lengths()));
+		} else {
+			BOOST_CHECK_EQUAL(header.num_strips, 0);
+		}
+	}
+	// only triangles can be stripified
+	stripify_file(triangles.name, strips.name);
+	BOOST_CHECK_THROW(stripify_file(strips.name, triangles.name), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(index_buffer_file_errors_test)
+{
+	TemporaryFile bad("indexbuffer_test_bad.bin");
+	BOOST_CHECK_THROW(IndexBufferFile file(bad.name), std::runtime_error);
+	{
+		std::ofstream file(bad.name.c_str(), std::ios::binary);
+		file << "not an index buffer file, but long enough for a header";
+	}
+	BOOST_CHECK_THROW(IndexBufferFile file(bad.name), std::runtime_error);
+	// truncated file
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(2);
+	write_index_buffer(bad.name, CONTENT_TRIANGLES, 4, indices.data(), indices.size(),
+	                   std::vector<std::size_t>());
+	std::filesystem::resize_file(bad.name, std::filesystem::file_size(bad.name) - 1);
+	BOOST_CHECK_THROW(IndexBufferFile file(bad.name), std::runtime_error);
+	BOOST_CHECK_THROW(write_index_buffer(bad.name, CONTENT_TRIANGLES, 4, indices.data(), 5,
+	                                     std::vector<std::size_t>()), std::runtime_error);
+	BOOST_CHECK_THROW(write_index_buffer(bad.name, CONTENT_TRIANGLES, 3, indices.data(), 6,
+	                                     std::vector<std::size_t>()), std::runtime_error);
+}
+
+//! Overwrite a number in the header of an index buffer file.
+void patch_header(const std::string & filename, std::size_t offset, boost::uint64_t value)
+{
+	std::fstream file(filename.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+	file.seekp(offset);
+	file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+BOOST_AUTO_TEST_CASE(index_buffer_file_corrupt_header_test)
+{
+	TemporaryFile bad("indexbuffer_test_corrupt.bin");
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(2);
+	write_index_buffer(bad.name, CONTENT_TRIANGLES, 4, indices.data(), indices.size(),
+	                   std::vector<std::size_t>());
+	BOOST_CHECK_NO_THROW(IndexBufferFile file(bad.name));
+	// more triangles than indices
+	patch_header(bad.name, offsetof(IndexBufferHeader, num_triangles), 1000000);
+	BOOST_CHECK_THROW(IndexBufferFile file(bad.name), std::runtime_error);
+	// number of indices not a multiple of 3
+	patch_header(bad.name, offsetof(IndexBufferHeader, num_triangles), indices.size() / 3);
+	BOOST_CHECK_NO_THROW(IndexBufferFile file(bad.name));
+	patch_header(bad.name, offsetof(IndexBufferHeader, num_indices), indices.size() - 1);
+	BOOST_CHECK_THROW(IndexBufferFile file(bad.name), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include "meshreader.hpp"
+
+typedef std::vector<boost::uint32_t> Indices;
+
+//! Faces of an OBJ file.
+Indices read_obj(const std::string & data)
+{
+	Indices indices;
+	parse_obj(data.data(), data.data() + data.size(), indices);
+	return indices;
+}
+
+//! Faces of a PLY file.
+Indices read_ply(const std::string & data)
+{
+	Indices indices;
+	parse_ply(data.data(), data.data() + data.size(), indices);
+	return indices;
+}
+
+//! Append an integer of size bytes to data.
+void put(std::string & data, boost::uint32_t value, int size, bool big_endian)
+{
+	for (int i = 0; i < size; i++) {
+		int shift = 8 * (big_endian ? size - 1 - i : i);
+		data.push_back(char((value >> shift) & 0xFF));
+	}
+}
+
+//! PLY file of four vertices, and a triangle and a quad, with count
+//! of given type and size, and int indices. Vertices and faces carry
+//! other properties, to be skipped.
+std::string quad_ply(bool big_endian, const char *count_type, int count_size)
+{
+	std::string data = "ply\n";
+	data += big_endian ? "format binary_big_endian 1.0\n" : "format binary_little_endian 1.0\n";
+	data += "comment made by meshreader_test\n";
+	data += "element vertex 4\n";
+	data += "property float x\nproperty float y\nproperty float z\n";
+	data += "element face 2\n";
+	data += "property uchar flags\n";
+	data += std::string("property list ") + count_type + " int vertex_indices\n";
+	data += "end_header\n";
+	for (int i = 0; i < 12; i++) put(data, 0x3F800000, 4, big_endian);
+	int faces[] = {3, 0, 1, 2, 4, 0, 2, 3, 1};
+	for (int f = 0, i = 0; f < 2; f++) {
+		put(data, 0xFF, 1, big_endian);
+		int count = faces[i++];
+		put(data, count, count_size, big_endian);
+		for (int k = 0; k < count; k++) put(data, faces[i++], 4, big_endian);
+	}
+	return data;
+}
+
+BOOST_AUTO_TEST_SUITE(meshreader_test_suite)
+
+BOOST_AUTO_TEST_CASE(parse_obj_test)
+{
+	Indices indices = read_obj(
+	                      "# four vertices\n"
+	                      "v 0 0 0\n"
+	                      "v 1 0 0\r\n"
+	                      "vt 0 0\n"
+	                      "vn 0 0 1\n"
+	                      "v 1 1 0\n"
+	                      "\tv 0 1 0\n"
+	                      "f 1 2 3\n"
+	                      "f 1/1 3/2/1 4//1 # comment\n"
+	                      "f -4 -2 -1\n"
+	                      "f 1 2 3 4\n");
+	boost::uint32_t expected[] = {0, 1, 2, 0, 2, 3, 0, 2, 3, 0, 1, 2, 0, 2, 3};
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(),
+	                              expected, expected + 15);
+	// negative indices count back from the vertices so far
+	indices = read_obj("v 0 0 0\nv 1 0 0\nv 1 1 0\nf -3 -2 -1\nv 0 1 0\nf -3 -2 -1\n");
+	boost::uint32_t expected_relative[] = {0, 1, 2, 1, 2, 3};
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(),
+	                              expected_relative, expected_relative + 6);
+	// faces may come before their vertices
+	indices = read_obj("f 1 2 3\nv 0 0 0\nv 1 0 0\nv 1 1 0\n");
+	BOOST_CHECK_EQUAL(indices.size(), 3);
+	BOOST_CHECK(read_obj("v 0 0 0\n").empty());
+}
+
+BOOST_AUTO_TEST_CASE(parse_obj_errors_test)
+{
+	const char *vertices = "v 0 0 0\nv 1 0 0\nv 1 1 0\n";
+	BOOST_CHECK_NO_THROW(read_obj(std::string(vertices) + "f 1 2 3\n"));
+	// out of range
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f 1 2 4\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f 0 1 2\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f -4 1 2\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f 1 2 99999999999\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj("f 1 2 3\n"), std::runtime_error);
+	// invalid faces
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f 1 2\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f a b c\n"), std::runtime_error);
+	BOOST_CHECK_THROW(read_obj(std::string(vertices) + "f 1 2 /3\n"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(parse_ply_test)
+{
+	boost::uint32_t expected[] = {0, 1, 2, 0, 2, 3, 0, 3, 1};
+	for (int big_endian = 0; big_endian < 2; big_endian++) {
+		Indices indices = read_ply(quad_ply(big_endian, "uchar", 1));
+		BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(),
+		                              expected, expected + 9);
+		indices = read_ply(quad_ply(big_endian, "int", 4));
+		BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(),
+		                              expected, expected + 9);
+		indices = read_ply(quad_ply(big_endian, "uint16", 2));
+		BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(),
+		                              expected, expected + 9);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parse_ply_errors_test)
+{
+	std::string data = quad_ply(false, "uchar", 1);
+	BOOST_CHECK_NO_THROW(read_ply(data));
+	// truncated body and header
+	BOOST_CHECK_THROW(read_ply(data.substr(0, data.size() - 1)), std::runtime_error);
+	BOOST_CHECK_THROW(read_ply(data.substr(0, data.find("end_header"))), std::runtime_error);
+	// not binary
+	std::string ascii = data;
+	ascii.replace(ascii.find("binary_little_endian"), 20, "ascii");
+	BOOST_CHECK_THROW(read_ply(ascii), std::runtime_error);
+	BOOST_CHECK_THROW(read_ply("obj\n"), std::runtime_error);
+	// no vertex indices
+	std::string unnamed = data;
+	unnamed.replace(unnamed.find("vertex_indices"), 14, "vertex_indixes");
+	BOOST_CHECK_THROW(read_ply(unnamed), std::runtime_error);
+	// index out of range, and negative index
+	std::string fewer = data;
+	fewer.replace(fewer.find("vertex 4"), 8, "vertex 3");
+	fewer.erase(fewer.find("end_header\n") + 11, 12);
+	BOOST_CHECK_THROW(read_ply(fewer), std::runtime_error);
+	std::string negative = data;
+	negative[negative.size() - 1] = char(0xFF);
+	BOOST_CHECK_THROW(read_ply(negative), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <boost/foreach.hpp>
+
+#include "streamstripifier.hpp"
+#include "testmesh.hpp"
+
+//! Stream indices through stripify_stream, and return the output.
+std::vector<boost::uint32_t> stripify_indices(const std::vector<boost::uint32_t> & indices,
+        std::size_t memory_budget, const StripifyOptions & options)
+{
+	std::stringstream input, output;
+	input.write(reinterpret_cast<const char *>(indices.data()),
+	            indices.size() * sizeof(boost::uint32_t));
+	stripify_stream(input, output, memory_budget, options);
+	std::string bytes = output.str();
+	std::vector<boost::uint32_t> result(bytes.size() / sizeof(boost::uint32_t));
+	bytes.copy(reinterpret_cast<char *>(result.data()), bytes.size());
+	return result;
+}
+
+BOOST_AUTO_TEST_SUITE(stream_stripifier_test_suite)
+
+BOOST_AUTO_TEST_CASE(stream_stripifier_outputs_test)
+{
+	// 20000 triangles, in chunks of at most 1024 triangles
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(100);
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < indices.size(); i += 3)
+		faces.insert(Face(indices[i], indices[i + 1], indices[i + 2]));
+	StripifyOptions options;
+	// strips, each preceded by its length
+	options.output = OUTPUT_STRIPS;
+	std::vector<boost::uint32_t> result = stripify_indices(indices, 0, options);
+	std::set<Face> strip_faces;
+	std::size_t num_strips = 0;
+	for (std::vector<boost::uint32_t>::const_iterator i = result.begin(); i != result.end();) {
+		boost::uint32_t length = *i++;
+		BOOST_REQUIRE(result.end() - i >= length);
+		BOOST_CHECK(triangulate(i, i + length, strip_faces));
+		i += length;
+		num_strips++;
+	}
+	BOOST_CHECK(strip_faces == faces);
+	// strips along chunk borders are carried over rather than cut,
+	// so there are about as many strips as without streaming
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(indices.data(), indices.size() / 3, strip_indices, strip_lengths);
+	BOOST_CHECK_LE(num_strips, 2 * strip_lengths.size());
+	// stitched strip
+	options.output = OUTPUT_STITCHED_STRIP;
+	result = stripify_indices(indices, 0, options);
+	strip_faces.clear();
+	BOOST_CHECK(triangulate(result.begin(), result.end(), strip_faces));
+	BOOST_CHECK(strip_faces == faces);
+	// strip with restarts
+	options.output = OUTPUT_RESTART_STRIP;
+	result = stripify_indices(indices, 0, options);
+	strip_faces.clear();
+	std::vector<boost::uint32_t>::const_iterator first = result.begin();
+	for (std::vector<boost::uint32_t>::const_iterator i = result.begin(); ; ++i) {
+		if ((i == result.end()) || (*i == options.restart_index)) {
+			BOOST_CHECK(triangulate(first, i, strip_faces));
+			if (i == result.end()) break;
+			first = i + 1;
+		}
+	}
+	BOOST_CHECK(strip_faces == faces);
+	// triangle list
+	options.output = OUTPUT_TRIANGLE_LIST;
+	result = stripify_indices(indices, 0, options);
+	BOOST_CHECK_EQUAL(result.size(), indices.size());
+	strip_faces.clear();
+	for (std::size_t i = 0; i < result.size(); i += 3)
+		BOOST_CHECK(triangulate(result.begin() + i, result.begin() + i + 3, strip_faces));
+	BOOST_CHECK(strip_faces == faces);
+}
+
+BOOST_AUTO_TEST_CASE(stream_stripifier_budget_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(100);
+	std::stringstream output;
+	StreamStripifier stripifier(output, 4096 * StreamStripifier::BYTES_PER_TRIANGLE);
+	BOOST_CHECK_EQUAL(stripifier.max_chunk_triangles, 4096);
+	// triangles may come in any pieces
+	for (std::size_t i = 0; i < indices.size(); i += 3 * 999) {
+		std::size_t num_triangles = std::min<std::size_t>(999, (indices.size() - i) / 3);
+		stripifier.add_triangles(&indices[i], num_triangles);
+	}
+	stripifier.finish();
+	BOOST_CHECK_EQUAL(stripifier.num_triangles, 20000);
+	// every chunk has at least half the maximal size in new
+	// triangles
+	BOOST_CHECK_LE(stripifier.num_chunks, 20000 / 2048 + 2);
+	BOOST_CHECK_EQUAL(output.str().size(),
+	                  sizeof(boost::uint32_t) * (stripifier.num_strips + stripifier.num_indices));
+	// a tiny budget still gives chunks of reasonable size
+	StreamStripifier small(output, 1);
+	BOOST_CHECK_EQUAL(small.max_chunk_triangles, StreamStripifier::MIN_CHUNK_TRIANGLES);
+}
+
+BOOST_AUTO_TEST_CASE(stream_stripifier_degenerate_test)
+{
+	// degenerate triangles are dropped, also when they are read
+	// ahead for the border of the chunk before them
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(28);
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < indices.size(); i += 3)
+		faces.insert(Face(indices[i], indices[i + 1], indices[i + 2]));
+	boost::uint32_t degenerate[] = {5, 5, 6};
+	indices.insert(indices.begin() + 3 * 700, degenerate, degenerate + 3);
+	StripifyOptions options;
+	std::vector<boost::uint32_t> result = stripify_indices(indices, 0, options);
+	std::set<Face> strip_faces;
+	for (std::vector<boost::uint32_t>::const_iterator i = result.begin(); i != result.end();) {
+		boost::uint32_t length = *i++;
+		BOOST_REQUIRE(result.end() - i >= length);
+		BOOST_CHECK(triangulate(i, i + length, strip_faces));
+		i += length;
+	}
+	BOOST_CHECK(strip_faces == faces);
+}
+
+BOOST_AUTO_TEST_CASE(stream_stripifier_errors_test)
+{
+	std::stringstream input, output;
+	boost::uint32_t indices[] = {0, 1, 2, 2, 1};
+	input.write(reinterpret_cast<const char *>(indices), sizeof(indices));
+	BOOST_CHECK_THROW(stripify_stream(input, output, 0), std::runtime_error);
+	std::vector<boost::uint32_t> triangle(indices, indices + 3);
+	triangle[2] = 0xFFFFFFFF;
+	StripifyOptions options;
+	options.output = OUTPUT_RESTART_STRIP;
+	BOOST_CHECK_THROW(stripify_indices(triangle, 0, options), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
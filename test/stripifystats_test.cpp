@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <boost/foreach.hpp>
+
+#include "stripifystats.hpp"
+#include "testmesh.hpp"
+#include "trianglemesh.hpp"
+#include "trianglestripifier.hpp"
+#include "tristrip.hpp"
+
+BOOST_AUTO_TEST_CASE(mesh_stats_test)
+{
+	// a face, a degenerate triangle, the face again, and another face
+	boost::uint32_t indices[] = {0, 1, 2, 3, 3, 4, 1, 2, 0, 2, 1, 3};
+	StripifyStats stats;
+	Mesh mesh(indices, 4, &stats);
+	BOOST_CHECK_EQUAL(stats.num_triangles, 4);
+	BOOST_CHECK_EQUAL(stats.num_degenerate_triangles, 1);
+	BOOST_CHECK_EQUAL(stats.num_duplicate_triangles, 1);
+	BOOST_CHECK_EQUAL(stats.num_faces, 2);
+	BOOST_CHECK_EQUAL(stats.num_faces, mesh.faces.size());
+	BOOST_CHECK(stats.face_seconds >= 0.0);
+	BOOST_CHECK(stats.adjacency_seconds >= 0.0);
+	// counters are added to
+	Mesh other_mesh(indices, 4, &stats);
+	BOOST_CHECK_EQUAL(stats.num_triangles, 8);
+	BOOST_CHECK_EQUAL(stats.num_faces, 4);
+	stats.clear();
+	BOOST_CHECK_EQUAL(stats.num_triangles, 0);
+}
+
+BOOST_AUTO_TEST_CASE(stripifier_stats_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(20);
+	std::size_t num_triangles = indices.size() / 3;
+	MeshPtr mesh(new Mesh(indices.data(), num_triangles));
+	TriangleStripifier stripifier(mesh);
+	StripifyStats stats;
+	stripifier.stats = &stats;
+	std::list<TriangleStripPtr> strips = stripifier.find_all_strips();
+	// the histogram counts every committed strip, and face
+	BOOST_CHECK_EQUAL(stats.get_num_strips(), strips.size());
+	std::size_t num_faces = 0;
+	for (std::size_t i = 0; i < stats.strip_length_histogram.size(); i++)
+		num_faces += i * stats.strip_length_histogram[i];
+	BOOST_CHECK_EQUAL(num_faces, mesh->faces.size());
+	// every round builds three experiments for each new reset point
+	BOOST_CHECK(stats.num_rounds > 0);
+	BOOST_CHECK(stats.num_rounds <= strips.size());
+	BOOST_CHECK(stats.num_reset_points >= stats.num_rounds);
+	BOOST_CHECK(stats.num_experiments <= 3 * stats.num_reset_points);
+	BOOST_CHECK(stats.num_aborted_experiments < stats.num_experiments);
+	// committed strips were traversed at least once, and every
+	// traversed face was probed
+	BOOST_CHECK(stats.num_traversed_faces >= mesh->faces.size() - strips.size());
+	BOOST_CHECK(stats.num_adjacency_probes >= stats.num_traversed_faces);
+	BOOST_CHECK(stats.experiment_seconds >= 0.0);
+	// the same strips without stats
+	TriangleStripifier other_stripifier(mesh);
+	std::list<TriangleStripPtr> other_strips = other_stripifier.find_all_strips();
+	BOOST_CHECK_EQUAL(other_strips.size(), strips.size());
+}
+
+BOOST_AUTO_TEST_CASE(stripify_batch_stats_test)
+{
+	std::vector<std::vector<boost::uint32_t> > buffers;
+	for (int size = 0; size < 20; size++)
+		buffers.push_back(grid<boost::uint32_t>(size));
+	std::vector<BatchMesh> meshes;
+	BOOST_FOREACH(const std::vector<boost::uint32_t> & buffer, buffers) {
+		BatchMesh mesh = {buffer.data(), buffer.size() / 3};
+		meshes.push_back(mesh);
+	}
+	// stats of all threads add up to those of separate calls
+	StripifyOptions options;
+	StripifyStats stats;
+	options.stats = &stats;
+	std::vector<BatchStrips> strips;
+	stripify_batch(meshes, strips, 3, 0, options);
+	StripifyStats expected;
+	options.stats = &expected;
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	std::size_t num_strips = 0;
+	BOOST_FOREACH(const BatchMesh & mesh, meshes) {
+		stripify(mesh.indices, mesh.num_triangles, strip_indices, strip_lengths, options);
+		num_strips += strip_lengths.size();
+	}
+	BOOST_CHECK_EQUAL(stats.num_triangles, expected.num_triangles);
+	BOOST_CHECK_EQUAL(stats.num_faces, expected.num_faces);
+	BOOST_CHECK_EQUAL(stats.num_rounds, expected.num_rounds);
+	BOOST_CHECK_EQUAL(stats.num_experiments, expected.num_experiments);
+	BOOST_CHECK_EQUAL(stats.num_aborted_experiments, expected.num_aborted_experiments);
+	BOOST_CHECK_EQUAL(stats.num_traversed_faces, expected.num_traversed_faces);
+	BOOST_CHECK_EQUAL(stats.num_adjacency_probes, expected.num_adjacency_probes);
+	BOOST_CHECK_EQUAL(stats.num_reset_point_skips, expected.num_reset_point_skips);
+	BOOST_CHECK(stats.strip_length_histogram == expected.strip_length_histogram);
+	BOOST_CHECK_EQUAL(stats.get_num_strips(), num_strips);
+}
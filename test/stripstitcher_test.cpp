@@ -0,0 +1,175 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <boost/foreach.hpp>
+
+#include "stripstitcher.hpp"
+#include "trianglemesh.hpp"
+
+//! Faces of a strip, skipping degenerate faces.
+void triangulate(const std::deque<int> & strip, std::multiset<Face> & faces)
+{
+	for (std::size_t i = 0; i + 2 < strip.size(); i++) {
+		int v0 = strip[i];
+		int v1 = strip[i + 1];
+		int v2 = strip[i + 2];
+		if ((v0 == v1) || (v1 == v2) || (v2 == v0)) continue;
+		faces.insert((i & 1) ? Face(v0, v2, v1) : Face(v0, v1, v2));
+	}
+}
+
+std::deque<int> make_strip(int v0, int v1, int v2, int v3 = -1)
+{
+	std::deque<int> strip;
+	strip.push_back(v0);
+	strip.push_back(v1);
+	strip.push_back(v2);
+	if (v3 != -1) strip.push_back(v3);
+	return strip;
+}
+
+BOOST_AUTO_TEST_SUITE(strip_stitcher_test_suite)
+
+BOOST_AUTO_TEST_CASE(stitch_reorder_test)
+{
+	std::vector<std::deque<int> > strips;
+	strips.push_back(make_strip(0, 1, 2, 3));
+	strips.push_back(make_strip(10, 11, 12));
+	strips.push_back(make_strip(3, 4, 5, 6));
+	// the strip starting with 3 goes next, with one extra index
+	int expected[] = {0, 1, 2, 3, 3, 4, 5, 6, 6, 10, 10, 11, 12};
+	std::deque<int> result = stitch_strips(strips);
+	BOOST_CHECK_EQUAL(result.size(), 13);
+	BOOST_CHECK(std::equal(result.begin(), result.end(), expected));
+}
+
+BOOST_AUTO_TEST_CASE(stitch_parity_test)
+{
+	std::vector<std::deque<int> > strips;
+	strips.push_back(make_strip(0, 1, 2));
+	strips.push_back(make_strip(5, 6, 7));
+	// second strip starts at an odd position, so it is reversed
+	int expected[] = {0, 1, 2, 2, 7, 7, 6, 5};
+	std::deque<int> result = stitch_strips(strips);
+	BOOST_CHECK_EQUAL(result.size(), 8);
+	BOOST_CHECK(std::equal(result.begin(), result.end(), expected));
+	std::multiset<Face> faces;
+	triangulate(strips[0], faces);
+	triangulate(strips[1], faces);
+	std::multiset<Face> result_faces;
+	triangulate(result, result_faces);
+	BOOST_CHECK(result_faces == faces);
+}
+
+BOOST_AUTO_TEST_CASE(stitch_shared_end_test)
+{
+	std::vector<std::deque<int> > strips;
+	strips.push_back(make_strip(0, 1, 2));
+	strips.push_back(make_strip(5, 6, 7, 8));
+	strips.push_back(make_strip(3, 4, 2));
+	// the last strip ends with 2, so it goes next, reversed, at
+	// an odd position, with one extra index
+	int expected[] = {0, 1, 2, 2, 4, 3, 3, 5, 5, 6, 7, 8};
+	std::deque<int> result = stitch_strips(strips);
+	BOOST_CHECK_EQUAL(result.size(), 12);
+	BOOST_CHECK(std::equal(result.begin(), result.end(), expected));
+}
+
+BOOST_AUTO_TEST_CASE(stitch_fan_test)
+{
+	// many strips around a single vertex, of both parities
+	std::vector<std::deque<int> > strips;
+	for (int i = 0; i < 50; i++) {
+		if (i % 3) {
+			strips.push_back(make_strip(0, 2 * i + 1, 2 * i + 2));
+		} else {
+			strips.push_back(make_strip(2 * i + 2, 0, 2 * i + 1, 200 + i));
+		}
+	}
+	std::multiset<Face> faces;
+	std::size_t num_indices = 0;
+	BOOST_FOREACH(const std::deque<int> & strip, strips) {
+		triangulate(strip, faces);
+		num_indices += strip.size();
+	}
+	std::deque<int> result = stitch_strips(strips);
+	std::multiset<Face> result_faces;
+	triangulate(result, result_faces);
+	BOOST_CHECK(result_faces == faces);
+	BOOST_CHECK_LE(result.size(), num_indices + 3 * (strips.size() - 1));
+}
+
+BOOST_AUTO_TEST_CASE(stitch_empty_test)
+{
+	std::vector<std::deque<int> > strips;
+	BOOST_CHECK(stitch_strips(strips).empty());
+	strips.push_back(make_strip(0, 1, 2, 3));
+	BOOST_CHECK(stitch_strips(strips) == strips[0]);
+}
+
+BOOST_AUTO_TEST_CASE(stitch_indices_test)
+{
+	BOOST_CHECK(get_stitch_indices(0, 0, make_strip(0, 1, 2)).empty());
+	// strips appended as they are keep their faces, whatever the
+	// parity and shared ends
+	std::deque<int> strips[] = {
+		make_strip(0, 1, 2), make_strip(2, 3, 4, 5), make_strip(6, 7, 8),
+		make_strip(8, 9, 10), make_strip(11, 12, 13, 14)
+	};
+	std::deque<int> result;
+	std::multiset<Face> faces;
+	BOOST_FOREACH(const std::deque<int> & strip, strips) {
+		std::vector<int> stitch = get_stitch_indices(result.size(),
+		                          result.empty() ? 0 : result.back(), strip);
+		BOOST_CHECK_LE(stitch.size(), 3);
+		result.insert(result.end(), stitch.begin(), stitch.end());
+		result.insert(result.end(), strip.begin(), strip.end());
+		triangulate(strip, faces);
+	}
+	std::multiset<Face> result_faces;
+	triangulate(result, result_faces);
+	BOOST_CHECK(result_faces == faces);
+	// shared end at an even position needs no extra index
+	BOOST_CHECK(get_stitch_indices(4, 2, make_strip(2, 3, 4, 5)).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Meshes and helpers shared by the tests.
+
+#ifndef TRISTRIP_TESTMESH_HPP
+#define TRISTRIP_TESTMESH_HPP
+
+#include <set>
+#include <vector>
+
+#include "trianglemesh.hpp"
+
+//! Faces of a strip, skipping degenerate faces. Returns false if
+//! any face was in faces already.
+template <typename Iterator>
+bool triangulate(Iterator first, Iterator last, std::set<Face> & faces)
+{
+	bool all_new = true;
+	bool forward = true;
+	for (; last - first >= 3; ++first, forward = !forward) {
+		int v0 = first[0];
+		int v1 = first[1];
+		int v2 = first[2];
+		if ((v0 == v1) || (v1 == v2) || (v2 == v0)) continue;
+		if (!faces.insert(forward ? Face(v0, v1, v2) : Face(v0, v2, v1)).second)
+			all_new = false;
+	}
+	return all_new;
+}
+
+//! Grid of size x size quads, split in two triangles each, row by
+//! row.
+template <typename Index>
+std::vector<Index> grid(unsigned int size)
+{
+	std::vector<Index> indices;
+	for (unsigned int y = 0; y < size; y++) {
+		for (unsigned int x = 0; x < size; x++) {
+			unsigned int v = y * (size + 1) + x;
+			Index quad[] = {Index(v), Index(v + 1), Index(v + size + 1),
+			                Index(v + size + 1), Index(v + 1), Index(v + size + 2)
+			               };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	return indices;
+}
+
+//! Positions of the vertices of grid, in the xy plane, three floats
+//! per vertex.
+inline std::vector<float> grid_positions(unsigned int size)
+{
+	std::vector<float> positions;
+	for (unsigned int y = 0; y <= size; y++) {
+		for (unsigned int x = 0; x <= size; x++) {
+			positions.push_back(x);
+			positions.push_back(y);
+			positions.push_back(0);
+		}
+	}
+	return positions;
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "threadpool.hpp"
+
+BOOST_AUTO_TEST_SUITE(threadpool_test_suite)
+
+BOOST_AUTO_TEST_CASE(threadpool_run_test)
+{
+	ThreadPool pool(4);
+	BOOST_CHECK_EQUAL(pool.size(), 4);
+	// run a few jobs, each task must run exactly once
+	for (int job = 0; job < 20; job++) {
+		std::vector<int> done(100, 0);
+		std::vector<int> workers(100, -1);
+		pool.run(done.size(), [&](int task, int worker) {
+			done[task]++;
+			workers[task] = worker;
+		});
+		for (int task = 0; task < 100; task++) {
+			BOOST_CHECK_EQUAL(done[task], 1);
+			BOOST_CHECK(workers[task] >= 0);
+			BOOST_CHECK(workers[task] < pool.size());
+		}
+	}
+	// no tasks
+	pool.run(0, [](int /*task*/, int /*worker*/) {
+		throw std::runtime_error("Task should not run.");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_single_test)
+{
+	// a pool of one runs everything on the calling thread
+	ThreadPool pool(1);
+	BOOST_CHECK_EQUAL(pool.size(), 1);
+	std::vector<int> order;
+	pool.run(5, [&](int task, int worker) {
+		BOOST_CHECK_EQUAL(worker, 0);
+		order.push_back(task);
+	});
+	BOOST_CHECK_EQUAL(order.size(), 5);
+	for (int task = 0; task < 5; task++)
+		BOOST_CHECK_EQUAL(order[task], task);
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_steal_test)
+{
+	// tasks are dealt round robin, so with two workers, the even
+	// tasks are queued on worker 0; worker 0 blocks on its first
+	// task until another worker has stolen one of its tasks
+	ThreadPool pool(2);
+	std::mutex mutex;
+	std::condition_variable stolen_done;
+	int num_stolen = 0;
+	std::vector<int> workers(9, -1);
+	pool.run(workers.size(), [&](int task, int worker) {
+		std::unique_lock<std::mutex> lock(mutex);
+		workers[task] = worker;
+		if (worker == 0) {
+			// time out rather than hang if nothing is stolen
+			stolen_done.wait_for(lock, std::chrono::seconds(10),
+			[&] { return num_stolen > 0; });
+		} else if (task % 2 == 0) {
+			num_stolen++;
+			stolen_done.notify_all();
+		}
+	});
+	BOOST_CHECK(num_stolen > 0);
+	for (int task = 0; task < 9; task++)
+		BOOST_CHECK(workers[task] != -1);
+}
+
+BOOST_AUTO_TEST_CASE(threadpool_exception_test)
+{
+	ThreadPool pool(3);
+	BOOST_CHECK_THROW(
+	pool.run(50, [](int task, int /*worker*/) {
+		if (task == 17) throw std::runtime_error("Task failed.");
+	}), std::runtime_error);
+	// pool is still usable
+	std::vector<int> done(10, 0);
+	pool.run(done.size(), [&](int task, int /*worker*/) {
+		done[task] = 1;
+	});
+	for (int task = 0; task < 10; task++)
+		BOOST_CHECK_EQUAL(done[task], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+#include "trianglelistoptimizer.hpp"
+#include "vertexcache.hpp"
+
+//! Grid of size x size quads, split in two triangles each, with the
+//! triangles in pseudo random order.
+MeshPtr shuffled_grid(int size)
+{
+	std::vector<int> order(2 * size * size);
+	for (int i = 0; i < int(order.size()); i++) order[i] = i;
+	unsigned int seed = 12345;
+	for (int i = order.size() - 1; i > 0; i--) {
+		seed = seed * 1103515245 + 12345;
+		std::swap(order[i], order[(seed >> 8) % (i + 1)]);
+	}
+	MeshPtr m(new Mesh());
+	BOOST_FOREACH(int i, order) {
+		int v = (i / 2 / size) * (size + 1) + (i / 2) % size;
+		if (i & 1) {
+			m->add_face(v + size + 1, v + 1, v + size + 2);
+		} else {
+			m->add_face(v, v + 1, v + size + 1);
+		}
+	}
+	return m;
+}
+
+//! Average number of cache misses per face, when drawing faces in
+//! given order.
+float get_acmr(const Mesh & m, const std::vector<int> & order, int cache_size)
+{
+	VertexCache cache(cache_size);
+	int num_misses = 0;
+	BOOST_FOREACH(int face, order) {
+		if (!cache.add(m.faces[face].v0)) num_misses++;
+		if (!cache.add(m.faces[face].v1)) num_misses++;
+		if (!cache.add(m.faces[face].v2)) num_misses++;
+	}
+	return float(num_misses) / order.size();
+}
+
+BOOST_AUTO_TEST_SUITE(triangle_list_optimizer_test_suite)
+
+BOOST_AUTO_TEST_CASE(vertex_score_test)
+{
+	TriangleListOptimizer t(MeshPtr(new Mesh()), 2);
+	BOOST_CHECK_EQUAL(t.cache_size, 4);
+	t.cache_size = 32;
+	// unused vertices score lowest
+	BOOST_CHECK_LT(t.get_vertex_score(0, 0), t.get_vertex_score(-1, 10));
+	// recently used vertices score higher
+	BOOST_CHECK_EQUAL(t.get_vertex_score(0, 3), t.get_vertex_score(2, 3));
+	BOOST_CHECK_GT(t.get_vertex_score(3, 3), t.get_vertex_score(10, 3));
+	BOOST_CHECK_GT(t.get_vertex_score(10, 3), t.get_vertex_score(-1, 3));
+	// vertices with fewer faces left score higher
+	BOOST_CHECK_GT(t.get_vertex_score(-1, 1), t.get_vertex_score(-1, 5));
+}
+
+BOOST_AUTO_TEST_CASE(find_face_order_test)
+{
+	MeshPtr m = shuffled_grid(30);
+	TriangleListOptimizer t(m, 16);
+	std::vector<int> order = t.find_face_order();
+	// every face exactly once
+	BOOST_CHECK_EQUAL(order.size(), m->faces.size());
+	std::vector<int> sorted_order(order);
+	std::sort(sorted_order.begin(), sorted_order.end());
+	for (int i = 0; i < int(sorted_order.size()); i++)
+		BOOST_CHECK_EQUAL(sorted_order[i], i);
+	// far fewer cache misses than the original order
+	std::vector<int> original_order(sorted_order);
+	float acmr = get_acmr(*m, order, 16);
+	BOOST_TEST_MESSAGE("acmr: " << get_acmr(*m, original_order, 16) << " -> " << acmr);
+	BOOST_CHECK_LT(acmr, 0.8);
+	BOOST_CHECK_GT(get_acmr(*m, original_order, 16), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(find_face_order_empty_test)
+{
+	TriangleListOptimizer t(MeshPtr(new Mesh()));
+	BOOST_CHECK(t.find_face_order().empty());
+}
+
+BOOST_AUTO_TEST_CASE(find_face_order_disconnected_test)
+{
+	// separate triangles, and large vertex indices
+	MeshPtr m(new Mesh());
+	m->add_face(1000000, 5, 7);
+	m->add_face(8, 9, 10);
+	m->add_face(5, 1000000, 11);
+	TriangleListOptimizer t(m);
+	std::vector<int> order = t.find_face_order();
+	BOOST_CHECK_EQUAL(order.size(), 3);
+	// the face sharing an edge is drawn next
+	BOOST_CHECK_EQUAL(order[0], 0);
+	BOOST_CHECK_EQUAL(order[1], 2);
+	BOOST_CHECK_EQUAL(order[2], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -119,9 +119,9 @@ BOOST_AUTO_TEST_CASE(mesh_add_face_test)
 	BOOST_CHECK_EQUAL(m._edges.size(), 9);
 	// add duplicate face
 	BOOST_CHECK_NO_THROW(m.add_face(2, 3, 4));
-	MFacePtr f0 = m.add_face(10, 11, 12);
-	MFacePtr f1 = m.add_face(12, 10, 11);
-	MFacePtr f2 = m.add_face(11, 12, 10);
+	int f0 = m.add_face(10, 11, 12);
+	int f1 = m.add_face(12, 10, 11);
+	int f2 = m.add_face(11, 12, 10);
 	BOOST_CHECK_EQUAL(f0, f1);
 	BOOST_CHECK_EQUAL(f0, f2);
 	// one extra face, three extra edges
@@ -133,9 +133,10 @@ BOOST_AUTO_TEST_CASE(face_faces_test_0)
 {
 	// construct mesh
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
-	MFacePtr f1 = m.add_face(1, 3, 2);
-	MFacePtr f2 = m.add_face(2, 3, 4);
+	int f0 = m.add_face(0, 1, 2);
+	int f1 = m.add_face(1, 3, 2);
+	int f2 = m.add_face(2, 3, 4);
+	m.lock();
 
 	// 0->-1
 	//  \ / \
@@ -145,96 +146,115 @@ BOOST_AUTO_TEST_CASE(face_faces_test_0)
 	//     4
 
 	// correct faces?
-	// f0->faces0 are faces opposite vertex 0, so along edge (1,2)
-	BOOST_CHECK_EQUAL(f0->faces0.size(), 1);
-	BOOST_CHECK_EQUAL(f0->faces0[0].lock(), f1);
-	// f0->faces1 are faces opposite vertex 1, so along edge (2,0)
-	BOOST_CHECK_EQUAL(f0->faces1.size(), 0);
-	// f0->faces2 are faces opposite vertex 2, so along edge (0,1)
-	BOOST_CHECK_EQUAL(f0->faces2.size(), 0);
-	// f1->faces0 are faces opposite vertex 1, so along edge (3,2)
-	BOOST_CHECK_EQUAL(f1->faces0.size(), 1);
-	BOOST_CHECK_EQUAL(f1->faces0[0].lock(), f2);
-	// f1->faces1 are faces opposite vertex 3, so along edge (2,1)
-	BOOST_CHECK_EQUAL(f1->faces1.size(), 1);
-	BOOST_CHECK_EQUAL(f1->faces1[0].lock(), f0);
-	// f1->faces2 are faces opposite vertex 2, so along edge (1,3)
-	BOOST_CHECK_EQUAL(f1->faces2.size(), 0);
-	// f2->faces0 are faces opposite vertex 2, so along edge (3,4)
-	BOOST_CHECK_EQUAL(f2->faces0.size(), 0);
-	// f2->faces1 are faces opposite vertex 3, so along edge (4,2)
-	BOOST_CHECK_EQUAL(f2->faces1.size(), 0);
-	// f2->faces2 are faces opposite vertex 4, so along edge (2,3)
-	BOOST_CHECK_EQUAL(f2->faces2.size(), 1);
-	BOOST_CHECK_EQUAL(f2->faces2[0].lock(), f1);
+	// m.get_adjacent_faces(f0, 0) are faces opposite vertex 0, so along edge (1,2)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0).size(), 1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0)[0], f1);
+	// m.get_adjacent_faces(f0, 1) are faces opposite vertex 1, so along edge (2,0)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 1).size(), 0);
+	// m.get_adjacent_faces(f0, 2) are faces opposite vertex 2, so along edge (0,1)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 2).size(), 0);
+	// m.get_adjacent_faces(f1, 1) are faces opposite vertex 1, so along edge (3,2)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1).size(), 1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1)[0], f2);
+	// m.get_adjacent_faces(f1, 3) are faces opposite vertex 3, so along edge (2,1)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 3).size(), 1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 3)[0], f0);
+	// m.get_adjacent_faces(f1, 2) are faces opposite vertex 2, so along edge (1,3)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 2).size(), 0);
+	// m.get_adjacent_faces(f2, 2) are faces opposite vertex 2, so along edge (3,4)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 2).size(), 0);
+	// m.get_adjacent_faces(f2, 3) are faces opposite vertex 3, so along edge (4,2)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 3).size(), 0);
+	// m.get_adjacent_faces(f2, 4) are faces opposite vertex 4, so along edge (2,3)
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 4).size(), 1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 4)[0], f1);
 }
 
 BOOST_AUTO_TEST_CASE(face_faces_test_1)
 {
 	// construct mesh
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
-	MFacePtr f1 = m.add_face(1, 3, 2);
-	MFacePtr f2 = m.add_face(2, 3, 4);
-	MFacePtr f3 = m.add_face(2, 3, 5);
+	int f0 = m.add_face(0, 1, 2);
+	int f1 = m.add_face(1, 3, 2);
+	int f2 = m.add_face(2, 3, 4);
+	int f3 = m.add_face(2, 3, 5);
+	m.lock();
 	// edge with no adjacent faces:
-	BOOST_CHECK_EQUAL(f0->faces2.size(), 0); // f0 0 1
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 2).size(), 0); // f0 0 1
 	// edge with one adjacent face
-	BOOST_CHECK_EQUAL(f0->faces0.size(), 1); // f0 1 2
-	BOOST_CHECK_EQUAL(f1->faces1.size(), 1); // f1 2 1
-	BOOST_CHECK_EQUAL(f0->faces0[0].lock(), f1);
-	BOOST_CHECK_EQUAL(f1->faces1[0].lock(), f0);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0).size(), 1); // f0 1 2
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 3).size(), 1); // f1 2 1
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0)[0], f1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 3)[0], f0);
 	// edge with two adjacent faces
-	BOOST_CHECK_EQUAL(f1->faces0.size(), 2); // f1 3 2
-	BOOST_CHECK_EQUAL(f2->faces2.size(), 1); // f2 2 3
-	BOOST_CHECK_EQUAL(f3->faces2.size(), 1); // f3 2 3
-	BOOST_CHECK_EQUAL(f1->faces0[0].lock(), f2);
-	BOOST_CHECK_EQUAL(f1->faces0[1].lock(), f3);
-	BOOST_CHECK_EQUAL(f2->faces2[0].lock(), f1);
-	BOOST_CHECK_EQUAL(f3->faces2[0].lock(), f1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1).size(), 2); // f1 3 2
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 4).size(), 1); // f2 2 3
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f3, 5).size(), 1); // f3 2 3
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1)[0], f2);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1)[1], f3);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 4)[0], f1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f3, 5)[0], f1);
 }
 
 BOOST_AUTO_TEST_CASE(fac_faces_test_2)
 {
 	// single triangle mesh
 	Mesh m;
-	MFacePtr f = m.add_face(0, 1, 2);
-	BOOST_CHECK_EQUAL(f->faces0.size(), 0);
-	BOOST_CHECK_EQUAL(f->faces1.size(), 0);
-	BOOST_CHECK_EQUAL(f->faces2.size(), 0);
+	int f = m.add_face(0, 1, 2);
+	m.lock();
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f, 0).size(), 0);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f, 1).size(), 0);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f, 2).size(), 0);
 }
 
 BOOST_AUTO_TEST_CASE(face_get_adjacent_faces_test_0)
 {
 	// construct slightly more complicated mesh
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
-	MFacePtr f1 = m.add_face(1, 3, 2);
-	MFacePtr f2 = m.add_face(2, 3, 4);
-	MFacePtr f3 = m.add_face(2, 5, 3);
-	MFacePtr f4 = m.add_face(1, 9, 2);
+	int f0 = m.add_face(0, 1, 2);
+	int f1 = m.add_face(1, 3, 2);
+	int f2 = m.add_face(2, 3, 4);
+	m.add_face(2, 5, 3);
+	int f4 = m.add_face(1, 9, 2);
+	m.lock();
 
 	// check the function by doing a quick strip traversal
-	MFacePtr f = f0;                                            // 0 1 2
-	BOOST_CHECK_EQUAL(f0->get_adjacent_faces(0).size(), 2);
-	BOOST_CHECK_EQUAL(f0->get_adjacent_faces(0)[0].lock(), f1); // 1 3 2
-	BOOST_CHECK_EQUAL(f1->get_adjacent_faces(1).size(), 1);
-	BOOST_CHECK_EQUAL(f1->get_adjacent_faces(1)[0].lock(), f2); // 2 3 4
-	BOOST_CHECK_EQUAL(f2->get_adjacent_faces(2).size(), 0);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0).size(), 2);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0)[0], f1); // 1 3 2
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1).size(), 1);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f1, 1)[0], f2); // 2 3 4
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f2, 2).size(), 0);
 
 	// alternative direction for strip
-	BOOST_CHECK_EQUAL(f0->get_adjacent_faces(0)[1].lock(), f4); // 1 9 2
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0)[1], f4); // 1 9 2
 }
 
 BOOST_AUTO_TEST_CASE(face_get_adjacent_faces_test_1)
 {
 	MeshPtr m(new Mesh());
-	MFacePtr f1 = m->add_face(5, 3, 2);
-	MFacePtr f2 = m->add_face(1, 0, 8);
-	MFacePtr f3 = m->add_face(0, 8, 9); // bad orientation!
-	MFacePtr f4 = m->add_face(8, 0, 10);
-	BOOST_CHECK_EQUAL(f2->get_adjacent_faces(1).size(), 1);
-	BOOST_CHECK_EQUAL(f2->get_adjacent_faces(1)[0].lock(), f4);
+	m->add_face(5, 3, 2);
+	int f2 = m->add_face(1, 0, 8);
+	m->add_face(0, 8, 9); // bad orientation!
+	int f4 = m->add_face(8, 0, 10);
+	m->lock();
+	BOOST_CHECK_EQUAL(m->get_adjacent_faces(f2, 1).size(), 1);
+	BOOST_CHECK_EQUAL(m->get_adjacent_faces(f2, 1)[0], f4);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_lock_test)
+{
+	Mesh m;
+	int f0 = m.add_face(0, 1, 2);
+	// adjacency is only available on locked meshes
+	BOOST_CHECK_THROW(m.get_adjacent_faces(f0, 0), std::runtime_error);
+	m.lock();
+	BOOST_CHECK_EQUAL(m._edges.size(), 0);
+	BOOST_CHECK_EQUAL(m._faces.size(), 0);
+	BOOST_CHECK_EQUAL(m.adjacency_offsets.size(), 4);
+	BOOST_CHECK_EQUAL(m.get_adjacent_faces(f0, 0).size(), 0);
+	// locking twice is harmless, adding faces is not allowed
+	BOOST_CHECK_NO_THROW(m.lock());
+	BOOST_CHECK_THROW(m.add_face(2, 1, 3), std::runtime_error);
 }
 
 BOOST_AUTO_TEST_CASE(mesh_edgemap_test)
@@ -244,17 +264,108 @@ BOOST_AUTO_TEST_CASE(mesh_edgemap_test)
 	Edge edge_index3(1, 0);
 	Edge edge_index4(2, 0);
 	Mesh::EdgeMap edges;
-	MEdgePtr edge(new MEdge(edge_index1));
-	edges[edge_index1] = edge;
+	edges[edge_index1.key()] = std::make_pair(3, 6);
 	Mesh::EdgeMap::const_iterator edge_iter;
-	edge_iter = edges.find(edge_index1);
-	BOOST_CHECK_EQUAL(edge_iter->second, edge);
-	edge_iter = edges.find(edge_index2);
-	BOOST_CHECK_EQUAL(edge_iter->second, edge);
-	edge_iter = edges.find(edge_index3);
+	edge_iter = edges.find(edge_index1.key());
+	BOOST_CHECK_EQUAL(edge_iter->second.first, 3);
+	BOOST_CHECK_EQUAL(edge_iter->second.second, 6);
+	edge_iter = edges.find(edge_index2.key());
+	BOOST_CHECK_EQUAL(edge_iter->second.first, 3);
+	BOOST_CHECK_EQUAL(edge_iter->second.second, 6);
+	edge_iter = edges.find(edge_index3.key());
 	BOOST_CHECK(edge_iter == edges.end());
-	edge_iter = edges.find(edge_index4);
+	edge_iter = edges.find(edge_index4.key());
 	BOOST_CHECK(edge_iter == edges.end());
 }
 
+BOOST_AUTO_TEST_CASE(mesh_reserve_test)
+{
+	// reserving must not change the result
+	Mesh m;
+	m.reserve(100);
+	BOOST_CHECK_EQUAL(m.faces.size(), 0);
+	for (int i = 0; i < 100; i++) m.add_face(i, i + 1, i + 2);
+	BOOST_CHECK_EQUAL(m.add_face(50, 51, 52), 50);
+	BOOST_CHECK_EQUAL(m.faces.size(), 100);
+	BOOST_CHECK_EQUAL(m._faces.size(), 100);
+	m.lock();
+	// face i = (i, i+1, i+2) shares edge (i+1, i+2) with face i+1,
+	// but in the same direction, so there are no adjacent faces
+	for (int i = 0; i < 100; i++) {
+		BOOST_CHECK_EQUAL(m.get_adjacent_faces(i, i).size(), 0);
+		BOOST_CHECK_EQUAL(m.get_adjacent_faces(i, i + 1).size(), 0);
+		BOOST_CHECK_EQUAL(m.get_adjacent_faces(i, i + 2).size(), 0);
+	}
+}
+
+//! Check that m1 and m2 have identical faces and adjacency.
+void check_same_mesh(const Mesh & m1, const Mesh & m2)
+{
+	BOOST_CHECK_EQUAL(m1.faces.size(), m2.faces.size());
+	for (int f = 0; f < int(m1.faces.size()); f++) {
+		BOOST_CHECK(m1.faces[f] == m2.faces[f]);
+	}
+	BOOST_CHECK(m1.adjacency_offsets == m2.adjacency_offsets);
+	BOOST_CHECK(m1.adjacency == m2.adjacency);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_bulk_build_test_0)
+{
+	// non-manifold mesh, with duplicate and degenerate faces
+	int indices[] = {
+		0, 1, 2, 1, 3, 2, 2, 3, 4, 2, 3, 5,
+		2, 5, 3, 1, 9, 2, 3, 3, 4, 2, 1, 3,
+		5, 3, 2, 2, 1, 0, 0, 1, 2, 7, 8, 7
+	};
+	Mesh m1;
+	for (int i = 0; i < 12; i++) {
+		int v0 = indices[3 * i];
+		int v1 = indices[3 * i + 1];
+		int v2 = indices[3 * i + 2];
+		if ((v0 != v1) && (v1 != v2) && (v2 != v0))
+			m1.add_face(v0, v1, v2);
+	}
+	m1.lock();
+	Mesh m2(indices, 12);
+	BOOST_CHECK_EQUAL(m2.faces.size(), 7);
+	check_same_mesh(m1, m2);
+	// built mesh is locked
+	BOOST_CHECK_THROW(m2.add_face(20, 21, 22), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_bulk_build_test_1)
+{
+	// pseudo random soup on few vertices, with all index types
+	std::vector<int> indices;
+	std::vector<boost::uint16_t> indices16;
+	std::vector<boost::uint32_t> indices32;
+	unsigned int seed = 12345;
+	for (int i = 0; i < 3 * 2000; i++) {
+		seed = seed * 1103515245 + 12345;
+		indices.push_back((seed >> 16) % 300);
+		indices16.push_back(indices.back());
+		indices32.push_back(indices.back());
+	}
+	Mesh m1;
+	for (int i = 0; i < 2000; i++) {
+		int v0 = indices[3 * i];
+		int v1 = indices[3 * i + 1];
+		int v2 = indices[3 * i + 2];
+		if ((v0 != v1) && (v1 != v2) && (v2 != v0))
+			m1.add_face(v0, v1, v2);
+	}
+	m1.lock();
+	check_same_mesh(m1, Mesh(&indices[0], 2000));
+	check_same_mesh(m1, Mesh(&indices16[0], 2000));
+	check_same_mesh(m1, Mesh(&indices32[0], 2000));
+}
+
+BOOST_AUTO_TEST_CASE(mesh_bulk_build_test_2)
+{
+	// empty mesh
+	Mesh m(static_cast<int *>(0), 0);
+	BOOST_CHECK_EQUAL(m.faces.size(), 0);
+	BOOST_CHECK_EQUAL(m.adjacency_offsets.size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
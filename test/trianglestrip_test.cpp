@@ -47,22 +47,25 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_0)
 {
 	// simple test
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
+	int f0 = m.add_face(0, 1, 2);
+	m.lock();
+	StripifierContext context(m);
 	int vertices[] = {0, 1, 2};
 	BOOST_FOREACH(int pv0, vertices) {
-		TriangleStrip t(pv0); // using vertex index as experiment id
+		TriangleStrip t(context, context.marks[0], pv0); // using vertex index as experiment id
 		t.build(pv0, f0);
 		BOOST_CHECK_EQUAL(t.reversed, false);
-		std::deque<int>::const_iterator i = t.vertices.begin();
+		TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 		BOOST_CHECK_EQUAL(*i++, pv0);
-		BOOST_CHECK_EQUAL(*i++, f0->get_next_vertex(pv0));
-		BOOST_CHECK_EQUAL(*i++, f0->get_next_vertex(f0->get_next_vertex(pv0)));
+		BOOST_CHECK_EQUAL(*i++, m.faces[f0].get_next_vertex(pv0));
+		BOOST_CHECK_EQUAL(*i++, m.faces[f0].get_next_vertex(m.faces[f0].get_next_vertex(pv0)));
 		BOOST_CHECK(i == t.vertices.end());
-		std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+		TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 		BOOST_CHECK_EQUAL(*j++, f0);
 		BOOST_CHECK(j == t.faces.end());
 		// not reversed, so...
-		BOOST_CHECK(t.get_strip() == t.vertices);
+		std::deque<int> strip = t.get_strip();
+	BOOST_CHECK(std::equal(strip.begin(), strip.end(), t.vertices.begin(), t.vertices.end()));
 	};
 }
 
@@ -71,85 +74,89 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_1)
 	// another simple test
 	// also tests get_strip on strips of length 4
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
-	MFacePtr f1 = m.add_face(2, 1, 3);
+	int f0 = m.add_face(0, 1, 2);
+	int f1 = m.add_face(2, 1, 3);
+	m.lock();
+	StripifierContext context(m);
 	{
-		TriangleStrip t(1);
+		TriangleStrip t(context, context.marks[0], 1);
 		t.build(0, f0);
 		BOOST_CHECK_EQUAL(t.reversed, false);
-		std::deque<int>::const_iterator i = t.vertices.begin();
+		TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 		BOOST_CHECK_EQUAL(*i++, 0);
 		BOOST_CHECK_EQUAL(*i++, 1);
 		BOOST_CHECK_EQUAL(*i++, 2);
 		BOOST_CHECK_EQUAL(*i++, 3);
 		BOOST_CHECK(i == t.vertices.end());
-		std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+		TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 		BOOST_CHECK_EQUAL(*j++, f0);
 		BOOST_CHECK_EQUAL(*j++, f1);
 		BOOST_CHECK(j == t.faces.end());
 		// not reversed, so...
-		BOOST_CHECK(t.get_strip() == t.vertices);
+		std::deque<int> strip = t.get_strip();
+	BOOST_CHECK(std::equal(strip.begin(), strip.end(), t.vertices.begin(), t.vertices.end()));
 	}
 	{
-		TriangleStrip t(2);
+		TriangleStrip t(context, context.marks[0], 2);
 		t.build(1, f0);
 		BOOST_CHECK_EQUAL(t.reversed, true);
-		std::deque<int>::const_iterator i = t.vertices.begin();
+		TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 		BOOST_CHECK_EQUAL(*i++, 3);
 		BOOST_CHECK_EQUAL(*i++, 1);
 		BOOST_CHECK_EQUAL(*i++, 2);
 		BOOST_CHECK_EQUAL(*i++, 0);
 		BOOST_CHECK(i == t.vertices.end());
-		std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+		TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 		BOOST_CHECK_EQUAL(*j++, f1);
 		BOOST_CHECK_EQUAL(*j++, f0);
 		BOOST_CHECK(j == t.faces.end());
 		std::deque<int> strip = t.get_strip();
-		i = strip.begin();
-		BOOST_CHECK_EQUAL(*i++, 3);
-		BOOST_CHECK_EQUAL(*i++, 2);
-		BOOST_CHECK_EQUAL(*i++, 1);
-		BOOST_CHECK_EQUAL(*i++, 0);
-		BOOST_CHECK(i == strip.end());
+		std::deque<int>::const_iterator k = strip.begin();
+		BOOST_CHECK_EQUAL(*k++, 3);
+		BOOST_CHECK_EQUAL(*k++, 2);
+		BOOST_CHECK_EQUAL(*k++, 1);
+		BOOST_CHECK_EQUAL(*k++, 0);
+		BOOST_CHECK(k == strip.end());
 	}
 	{
-		TriangleStrip t(3);
+		TriangleStrip t(context, context.marks[0], 3);
 		t.build(2, f1);
 		BOOST_CHECK_EQUAL(t.reversed, true);
-		std::deque<int>::const_iterator i = t.vertices.begin();
+		TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 		BOOST_CHECK_EQUAL(*i++, 0);
 		BOOST_CHECK_EQUAL(*i++, 2);
 		BOOST_CHECK_EQUAL(*i++, 1);
 		BOOST_CHECK_EQUAL(*i++, 3);
 		BOOST_CHECK(i == t.vertices.end());
-		std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+		TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 		BOOST_CHECK_EQUAL(*j++, f0);
 		BOOST_CHECK_EQUAL(*j++, f1);
 		BOOST_CHECK(j == t.faces.end());
 		std::deque<int> strip = t.get_strip();
-		i = strip.begin();
-		BOOST_CHECK_EQUAL(*i++, 0);
-		BOOST_CHECK_EQUAL(*i++, 1);
-		BOOST_CHECK_EQUAL(*i++, 2);
-		BOOST_CHECK_EQUAL(*i++, 3);
-		BOOST_CHECK(i == strip.end());
+		std::deque<int>::const_iterator k = strip.begin();
+		BOOST_CHECK_EQUAL(*k++, 0);
+		BOOST_CHECK_EQUAL(*k++, 1);
+		BOOST_CHECK_EQUAL(*k++, 2);
+		BOOST_CHECK_EQUAL(*k++, 3);
+		BOOST_CHECK(k == strip.end());
 	}
 	{
-		TriangleStrip t(4);
+		TriangleStrip t(context, context.marks[0], 4);
 		t.build(3, f1);
 		BOOST_CHECK_EQUAL(t.reversed, false);
-		std::deque<int>::const_iterator i = t.vertices.begin();
+		TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 		BOOST_CHECK_EQUAL(*i++, 3);
 		BOOST_CHECK_EQUAL(*i++, 2);
 		BOOST_CHECK_EQUAL(*i++, 1);
 		BOOST_CHECK_EQUAL(*i++, 0);
 		BOOST_CHECK(i == t.vertices.end());
-		std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+		TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 		BOOST_CHECK_EQUAL(*j++, f1);
 		BOOST_CHECK_EQUAL(*j++, f0);
 		BOOST_CHECK(j == t.faces.end());
 		// not reversed, so...
-		BOOST_CHECK(t.get_strip() == t.vertices);
+		std::deque<int> strip = t.get_strip();
+	BOOST_CHECK(std::equal(strip.begin(), strip.end(), t.vertices.begin(), t.vertices.end()));
 	}
 }
 
@@ -160,14 +167,16 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_2)
 	//  \ / \ / \
 	//   2---4---6
 	Mesh m;
-	MFacePtr f0 = m.add_face(1, 3, 2);
-	MFacePtr f1 = m.add_face(2, 3, 4);
-	MFacePtr f2 = m.add_face(4, 3, 5);
-	MFacePtr f3 = m.add_face(4, 5, 6);
-	TriangleStrip t(1);
+	m.add_face(1, 3, 2);
+	int f1 = m.add_face(2, 3, 4);
+	m.add_face(4, 3, 5);
+	m.add_face(4, 5, 6);
+	m.lock();
+	StripifierContext context(m);
+	TriangleStrip t(context, context.marks[0], 1);
 	t.build(2, f1);
 	BOOST_CHECK_EQUAL(t.reversed, true);
-	std::deque<int>::const_iterator i = t.vertices.begin();
+	TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 	BOOST_CHECK_EQUAL(*i++, 1);
 	BOOST_CHECK_EQUAL(*i++, 2);
 	BOOST_CHECK_EQUAL(*i++, 3);
@@ -176,28 +185,30 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_2)
 	BOOST_CHECK_EQUAL(*i++, 6);
 	BOOST_CHECK(i == t.vertices.end());
 	std::deque<int> strip = t.get_strip();
-	i = strip.begin();
-	BOOST_CHECK_EQUAL(*i++, 1); // extra vertex
-	BOOST_CHECK_EQUAL(*i++, 1);
-	BOOST_CHECK_EQUAL(*i++, 2);
-	BOOST_CHECK_EQUAL(*i++, 3);
-	BOOST_CHECK_EQUAL(*i++, 4);
-	BOOST_CHECK_EQUAL(*i++, 5);
-	BOOST_CHECK_EQUAL(*i++, 6);
-	BOOST_CHECK(i == strip.end());
+	std::deque<int>::const_iterator k = strip.begin();
+	BOOST_CHECK_EQUAL(*k++, 1); // extra vertex
+	BOOST_CHECK_EQUAL(*k++, 1);
+	BOOST_CHECK_EQUAL(*k++, 2);
+	BOOST_CHECK_EQUAL(*k++, 3);
+	BOOST_CHECK_EQUAL(*k++, 4);
+	BOOST_CHECK_EQUAL(*k++, 5);
+	BOOST_CHECK_EQUAL(*k++, 6);
+	BOOST_CHECK(k == strip.end());
 }
 
 BOOST_AUTO_TEST_CASE(triangle_strip_build_test_3)
 {
 	// checks that strip is reversed to fix winding
 	Mesh m;
-	MFacePtr f0 = m.add_face(1, 3, 2);
-	MFacePtr f1 = m.add_face(2, 3, 4);
-	MFacePtr f2 = m.add_face(3, 5, 4);
-	TriangleStrip t(1);
+	m.add_face(1, 3, 2);
+	int f1 = m.add_face(2, 3, 4);
+	m.add_face(3, 5, 4);
+	m.lock();
+	StripifierContext context(m);
+	TriangleStrip t(context, context.marks[0], 1);
 	t.build(2, f1);
 	BOOST_CHECK_EQUAL(t.reversed, true);
-	std::deque<int>::const_iterator i = t.vertices.begin();
+	TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 	BOOST_CHECK_EQUAL(*i++, 1);
 	BOOST_CHECK_EQUAL(*i++, 2);
 	BOOST_CHECK_EQUAL(*i++, 3);
@@ -205,32 +216,34 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_3)
 	BOOST_CHECK_EQUAL(*i++, 5);
 	BOOST_CHECK(i == t.vertices.end());
 	std::deque<int> strip = t.get_strip();
-	i = strip.begin();
-	BOOST_CHECK_EQUAL(*i++, 5); // reversed order
-	BOOST_CHECK_EQUAL(*i++, 4);
-	BOOST_CHECK_EQUAL(*i++, 3);
-	BOOST_CHECK_EQUAL(*i++, 2);
-	BOOST_CHECK_EQUAL(*i++, 1);
-	BOOST_CHECK(i == strip.end());
+	std::deque<int>::const_iterator k = strip.begin();
+	BOOST_CHECK_EQUAL(*k++, 5); // reversed order
+	BOOST_CHECK_EQUAL(*k++, 4);
+	BOOST_CHECK_EQUAL(*k++, 3);
+	BOOST_CHECK_EQUAL(*k++, 2);
+	BOOST_CHECK_EQUAL(*k++, 1);
+	BOOST_CHECK(k == strip.end());
 }
 
 BOOST_AUTO_TEST_CASE(triangle_strip_build_test_4)
 {
 	// construct slightly more complicated mesh
 	Mesh m;
-	MFacePtr f0 = m.add_face(0, 1, 2);
-	MFacePtr f1 = m.add_face(2, 1, 7);
-	MFacePtr f2 = m.add_face(2, 7, 4);
-	MFacePtr f3 = m.add_face(5, 3, 2);
-	MFacePtr f4 = m.add_face(2, 1, 9);
-	MFacePtr f5 = m.add_face(4, 7, 10);
-	MFacePtr f6 = m.add_face(4, 10, 11);
-	MFacePtr f7 = m.add_face(11, 10, 12);
-	MFacePtr f8 = m.add_face(1, 0, 13);
-	TriangleStrip t(1);
+	int f0 = m.add_face(0, 1, 2);
+	int f1 = m.add_face(2, 1, 7);
+	int f2 = m.add_face(2, 7, 4);
+	m.add_face(5, 3, 2);
+	m.add_face(2, 1, 9);
+	int f5 = m.add_face(4, 7, 10);
+	int f6 = m.add_face(4, 10, 11);
+	int f7 = m.add_face(11, 10, 12);
+	int f8 = m.add_face(1, 0, 13);
+	m.lock();
+	StripifierContext context(m);
+	TriangleStrip t(context, context.marks[0], 1);
 	t.build(7, f1);
 	BOOST_CHECK_EQUAL(t.reversed, false);
-	std::deque<int>::const_iterator i = t.vertices.begin();
+	TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 	BOOST_CHECK_EQUAL(*i++, 12);
 	BOOST_CHECK_EQUAL(*i++, 11);
 	BOOST_CHECK_EQUAL(*i++, 10);
@@ -241,7 +254,7 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_4)
 	BOOST_CHECK_EQUAL(*i++, 0);
 	BOOST_CHECK_EQUAL(*i++, 13);
 	BOOST_CHECK(i == t.vertices.end());
-	std::deque<MFacePtr>::const_iterator j = t.faces.begin();
+	TwoEndedBuffer<int>::const_iterator j = t.faces.begin();
 	BOOST_CHECK_EQUAL(*j++, f7);
 	BOOST_CHECK_EQUAL(*j++, f6);
 	BOOST_CHECK_EQUAL(*j++, f5);
@@ -251,23 +264,26 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_4)
 	BOOST_CHECK_EQUAL(*j++, f8);
 	BOOST_CHECK(j == t.faces.end());
 	// not reversed, so...
-	BOOST_CHECK(t.get_strip() == t.vertices);
+	std::deque<int> strip = t.get_strip();
+	BOOST_CHECK(std::equal(strip.begin(), strip.end(), t.vertices.begin(), t.vertices.end()));
 }
 
 BOOST_AUTO_TEST_CASE(triangle_strip_build_test_5)
 {
 	MeshPtr m(new Mesh());
 	m->add_face(2, 1, 7); // in strip
-	MFacePtr f1 = m->add_face(0, 1, 2); // in strip
+	int f1 = m->add_face(0, 1, 2); // in strip
 	m->add_face(2, 7, 4); // in strip
 	m->add_face(4, 7, 11); // in strip
 	m->add_face(5, 3, 2);
-	MFacePtr f2 = m->add_face(1, 0, 8); // in strip
+	m->add_face(1, 0, 8); // in strip
 	m->add_face(0, 8, 9); // bad orientation!
-	MFacePtr f3 = m->add_face(8, 0, 10); // in strip
-	TriangleStrip t(1);
+	m->add_face(8, 0, 10); // in strip
+	m->lock();
+	StripifierContext context(*m);
+	TriangleStrip t(context, context.marks[0], 1);
 	t.build(0, f1);
-	std::deque<int>::const_iterator i = t.vertices.begin();
+	TwoEndedBuffer<int>::const_iterator i = t.vertices.begin();
 	BOOST_CHECK_EQUAL(*i++, 10);
 	BOOST_CHECK_EQUAL(*i++, 8);
 	BOOST_CHECK_EQUAL(*i++, 0);
@@ -279,4 +295,36 @@ BOOST_AUTO_TEST_CASE(triangle_strip_build_test_5)
 	BOOST_CHECK(i == t.vertices.end());
 }
 
+BOOST_AUTO_TEST_CASE(triangle_strip_split_test)
+{
+	MeshPtr m(new Mesh());
+	m->add_face(2, 1, 7); // in strip
+	int f1 = m->add_face(0, 1, 2); // in strip
+	m->add_face(2, 7, 4); // in strip
+	m->add_face(1, 0, 8); // in strip
+	m->lock();
+	StripifierContext context(*m);
+	TriangleStrip t(context, context.marks[0], 1);
+	t.build(0, f1);
+	int vertices[] = {8, 0, 1, 2, 7, 4};
+	BOOST_CHECK_EQUAL(t.vertices.size(), 6);
+	BOOST_CHECK(std::equal(t.vertices.begin(), t.vertices.end(), vertices));
+	BOOST_CHECK_EQUAL(t.reversed, true);
+	// get_strip changes winding with a duplicate vertex
+	BOOST_CHECK_EQUAL(t.get_strip().size(), 7);
+	// get_split_strip splits off the first face instead
+	std::list<std::deque<int> > strips = t.get_split_strip();
+	BOOST_CHECK_EQUAL(strips.size(), 2);
+	int first[] = {8, 1, 0};
+	int second[] = {0, 1, 2, 7, 4};
+	BOOST_CHECK_EQUAL(strips.front().size(), 3);
+	BOOST_CHECK(std::equal(strips.front().begin(), strips.front().end(), first));
+	BOOST_CHECK_EQUAL(strips.back().size(), 5);
+	BOOST_CHECK(std::equal(strips.back().begin(), strips.back().end(), second));
+	// odd strips need no split
+	t.vertices.pop_back();
+	BOOST_CHECK_EQUAL(t.get_split_strip().size(), 1);
+	BOOST_CHECK(t.get_split_strip().front() == t.get_strip());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -39,37 +39,63 @@ POSSIBILITY OF SUCH DAMAGE.
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
+
 #include "trianglestripifier.hpp"
 
+//! Memory resource counting allocations, and bytes in use.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	std::size_t num_allocations;
+	std::size_t bytes_in_use;
+
+	CountingResource() : num_allocations(0), bytes_in_use(0) {};
+
+private:
+	void *do_allocate(std::size_t bytes, std::size_t alignment) {
+		num_allocations++;
+		bytes_in_use += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	};
+	void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+		bytes_in_use -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	};
+	bool do_is_equal(const std::pmr::memory_resource & other) const noexcept {
+		return this == &other;
+	};
+};
+
 BOOST_AUTO_TEST_SUITE(triangle_stripifier_test_suite)
 
 BOOST_AUTO_TEST_CASE(find_start_face_good_reset_point_test)
 {
 	MeshPtr m(new Mesh());
-	MFacePtr f0 = m->add_face(2, 1, 7);
-	MFacePtr f1 = m->add_face(0, 1, 2);
-	MFacePtr f2 = m->add_face(2, 7, 4);
-	MFacePtr f3 = m->add_face(5, 3, 2);
+	int f0 = m->add_face(2, 1, 7);
+	int f1 = m->add_face(0, 1, 2);
+	int f2 = m->add_face(2, 7, 4);
+	int f3 = m->add_face(5, 3, 2);
 	TriangleStripifier t(m);
 
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), true);
-	BOOST_CHECK_EQUAL(*t.start_face_iter, f0);
+	BOOST_CHECK_EQUAL(t.start_face, f0);
 	// try again: should find the same
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), true);
-	BOOST_CHECK_EQUAL(*t.start_face_iter, f0);
-	f0->strip_id = 1; // fake that it is stripified
+	BOOST_CHECK_EQUAL(t.start_face, f0);
+	t.context.set_strip_id(f0, 1); // fake that it is stripified
 
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), true);
-	BOOST_CHECK_EQUAL(*t.start_face_iter, f1);
-	f1->strip_id = 2; // fake that it is stripified
+	BOOST_CHECK_EQUAL(t.start_face, f1);
+	t.context.set_strip_id(f1, 2); // fake that it is stripified
 
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), true);
-	BOOST_CHECK_EQUAL(*t.start_face_iter, f2);
-	f2->strip_id = 3; // fake that it is stripified
+	BOOST_CHECK_EQUAL(t.start_face, f2);
+	t.context.set_strip_id(f2, 3); // fake that it is stripified
 
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), true);
-	BOOST_CHECK_EQUAL(*t.start_face_iter, f3);
-	f3->strip_id = 4; // fake that it is stripified
+	BOOST_CHECK_EQUAL(t.start_face, f3);
+	t.context.set_strip_id(f3, 4); // fake that it is stripified
 
 	BOOST_CHECK_EQUAL(t.find_good_reset_point(), false);
 }
@@ -81,7 +107,7 @@ BOOST_AUTO_TEST_CASE(experiment_build)
 	// first strip
 
 	m->add_face(2, 1, 7); // in strip
-	MFacePtr s1_face = m->add_face(0, 1, 2); // in strip
+	int s1_face = m->add_face(0, 1, 2); // in strip
 	m->add_face(2, 7, 4); // in strip
 	m->add_face(4, 7, 11); // in strip
 	m->add_face(5, 3, 2);
@@ -91,22 +117,24 @@ BOOST_AUTO_TEST_CASE(experiment_build)
 	m->add_face(10, 11, 8); // in strip
 
 	// parallel strip
-	MFacePtr s2_face = m->add_face(0, 2, 21); // in strip
+	m->add_face(0, 2, 21); // in strip
 	m->add_face(21, 2, 22); // in strip
 	m->add_face(2, 4, 22); // in strip
 	m->add_face(21, 24, 0); // in strip
 	m->add_face(9, 0, 24); // in strip
 
 	// parallel strip, further down
-	MFacePtr s3_face = m->add_face(8, 11, 31); // in strip
+	m->add_face(8, 11, 31); // in strip
 	m->add_face(8, 31, 32); // in strip
 	m->add_face(31, 11, 33); // in strip
 
 	// build experiment
-	ExperimentPtr exp(new Experiment(0, s1_face));
-	exp->build();
+	m->lock();
+	StripifierContext context(*m);
+	ExperimentPtr exp(new Experiment(context, 0, s1_face));
+	exp->build(context.marks[0]);
 
-	std::list<TriangleStripPtr>::const_iterator t = exp->strips.begin();
+	std::pmr::list<TriangleStripPtr>::const_iterator t = exp->strips.begin();
 
 	std::deque<int> strip = (*t)->get_strip();
 	std::deque<int>::const_iterator i = strip.begin();
@@ -154,6 +182,54 @@ BOOST_AUTO_TEST_CASE(experiment_build)
 	BOOST_CHECK(t == exp->strips.end());
 }
 
+BOOST_AUTO_TEST_CASE(experiment_bound)
+{
+	std::vector<int> indices;
+	int size = 10;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int v = y * (size + 1) + x;
+			int quad[] = {v, v + 1, v + size + 1, v + size + 1, v + 1, v + size + 2};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	MeshPtr m(new Mesh(&indices[0], indices.size() / 3));
+	m->lock();
+	ExperimentSelector selector(10, 0);
+	int cache_sizes[] = {0, 16};
+	BOOST_FOREACH(int cache_size, cache_sizes) {
+		StripifierContext context(*m, 1, cache_size);
+		for (int face = 0; face < int(m->faces.size()); face += 7) {
+			// the bound during building is never below the final score
+			std::vector<float> max_scores;
+			ExperimentPtr exp(new Experiment(context, m->faces[face].v0, face));
+			exp->build(context.marks[0], [&](const Experiment & experiment) {
+				max_scores.push_back(selector.get_max_score(experiment));
+				return true;
+			});
+			BOOST_CHECK(!exp->aborted);
+			BOOST_CHECK_EQUAL(max_scores.size(), exp->strips.size());
+			float score = selector.get_score(*exp);
+			BOOST_FOREACH(float max_score, max_scores) {
+				BOOST_CHECK(max_score >= score);
+			}
+			// once aborted, no more strips are built
+			ExperimentPtr aborted(new Experiment(context, m->faces[face].v0, face));
+			aborted->build(context.marks[0], [](const Experiment &) {
+				return false;
+			});
+			BOOST_CHECK(aborted->aborted);
+			BOOST_CHECK_EQUAL(aborted->strips.size(), 1);
+			// and the experiment is never selected
+			selector.update_score(aborted);
+			BOOST_CHECK(!selector.best_sample);
+			selector.update_score(exp);
+			BOOST_CHECK(selector.best_sample == exp);
+			selector.clear();
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(triangle_stripifier_find_all_strips_0)
 {
 	// stripify on empty mesh should not fail
@@ -170,7 +246,7 @@ BOOST_AUTO_TEST_CASE(triangle_stripifier_find_all_strips_1)
 	// first strip
 
 	m->add_face(2, 1, 7); // in strip
-	MFacePtr s1_face = m->add_face(0, 1, 2); // in strip
+	m->add_face(0, 1, 2); // in strip
 	m->add_face(2, 7, 4); // in strip
 	m->add_face(4, 7, 11); // in strip
 	m->add_face(5, 3, 2);
@@ -180,14 +256,14 @@ BOOST_AUTO_TEST_CASE(triangle_stripifier_find_all_strips_1)
 	m->add_face(10, 11, 8); // in strip
 
 	// parallel strip
-	MFacePtr s2_face = m->add_face(0, 2, 21); // in strip
+	m->add_face(0, 2, 21); // in strip
 	m->add_face(21, 2, 22); // in strip
 	m->add_face(2, 4, 22); // in strip
 	m->add_face(21, 24, 0); // in strip
 	m->add_face(9, 0, 24); // in strip
 
 	// parallel strip, further down
-	MFacePtr s3_face = m->add_face(8, 11, 31); // in strip
+	m->add_face(8, 11, 31); // in strip
 	m->add_face(8, 31, 32); // in strip
 	m->add_face(31, 11, 33); // in strip
 
@@ -251,4 +327,104 @@ BOOST_AUTO_TEST_CASE(triangle_stripifier_find_all_strips_1)
 	BOOST_CHECK(t == all_strips.end());
 }
 
+BOOST_AUTO_TEST_CASE(triangle_stripifier_find_all_strips_threads)
+{
+	// strips must not depend on the number of threads
+	std::vector<int> indices;
+	int size = 30;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int v = y * (size + 1) + x;
+			int quad[] = {v, v + 1, v + size + 1, v + size + 1, v + 1, v + size + 2};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	std::list<std::deque<int> > strips[3];
+	int num_threads[] = {1, 2, 4};
+	for (int i = 0; i < 3; i++) {
+		MeshPtr m(new Mesh(&indices[0], indices.size() / 3));
+		TriangleStripifier ts(m, num_threads[i]);
+		BOOST_CHECK_EQUAL(ts.pool.size(), num_threads[i]);
+		BOOST_FOREACH(TriangleStripPtr strip, ts.find_all_strips()) {
+			strips[i].push_back(strip->get_strip());
+		}
+	}
+	BOOST_CHECK(strips[0] == strips[1]);
+	BOOST_CHECK(strips[0] == strips[2]);
+}
+
+BOOST_AUTO_TEST_CASE(triangle_stripifier_concurrent)
+{
+	// stripifiers in separate threads, all on the same mesh, must
+	// give the same strips as a single stripifier
+	std::vector<int> indices;
+	int size = 20;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int v = y * (size + 1) + x;
+			int quad[] = {v, v + 1, v + size + 1, v + size + 1, v + 1, v + size + 2};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	MeshPtr m(new Mesh(&indices[0], indices.size() / 3));
+	std::list<std::deque<int> > strips[5];
+	int first_strip_ids[5];
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 5; i++) {
+		threads.push_back(std::thread([m, &strips, &first_strip_ids, i] {
+			TriangleStripifier ts(m);
+			std::list<TriangleStripPtr> all_strips = ts.find_all_strips();
+			first_strip_ids[i] = all_strips.front()->strip_id;
+			BOOST_FOREACH(TriangleStripPtr strip, all_strips) {
+				strips[i].push_back(strip->get_strip());
+			}
+		}));
+	}
+	BOOST_FOREACH(std::thread & thread, threads) thread.join();
+	for (int i = 0; i < 5; i++) {
+		BOOST_CHECK(strips[0] == strips[i]);
+		// ids are not shared between stripifiers
+		BOOST_CHECK_EQUAL(first_strip_ids[i], 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(triangle_stripifier_memory_resource)
+{
+	std::vector<int> indices;
+	int size = 30;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int v = y * (size + 1) + x;
+			int quad[] = {v, v + 1, v + size + 1, v + size + 1, v + 1, v + size + 2};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	MeshPtr m(new Mesh(&indices[0], indices.size() / 3));
+	std::list<std::deque<int> > strips;
+	{
+		TriangleStripifier ts(m);
+		BOOST_FOREACH(TriangleStripPtr strip, ts.find_all_strips()) {
+			strips.push_back(strip->get_strip());
+		}
+	}
+	CountingResource resource;
+	std::list<std::deque<int> > resource_strips;
+	{
+		TriangleStripifier ts(m, 2, 0, &resource);
+		std::list<TriangleStripPtr> all_strips = ts.find_all_strips();
+		BOOST_FOREACH(TriangleStripPtr strip, all_strips) {
+			resource_strips.push_back(strip->get_strip());
+		}
+		// committed strips are allocated from the resource, each
+		// with its faces and vertices, but experiments fit in the
+		// arenas, so they need no allocations at all
+		BOOST_CHECK_GT(resource.num_allocations, 0);
+		BOOST_CHECK_LE(resource.num_allocations, 10 * all_strips.size());
+		BOOST_CHECK_GT(resource.bytes_in_use, 0);
+	}
+	BOOST_CHECK(strips == resource_strips);
+	// everything is given back
+	BOOST_CHECK_EQUAL(resource.bytes_in_use, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
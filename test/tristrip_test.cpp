@@ -0,0 +1,425 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <boost/foreach.hpp>
+
+#include "trianglemesh.hpp"
+#include "cacheanalysis.hpp"
+#include "tristrip.hpp"
+
+#include "testmesh.hpp"
+
+BOOST_AUTO_TEST_SUITE(tristrip_test_suite)
+
+BOOST_AUTO_TEST_CASE(stripify_buffer_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(10);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+
+	// list based interface
+	std::list<std::list<int> > triangles;
+	for (std::size_t i = 0; i < num_triangles; i++) {
+		std::list<int> triangle(&indices[3 * i], &indices[3 * i + 3]);
+		triangles.push_back(triangle);
+	}
+	std::list<std::deque<int> > strips = stripify(triangles);
+
+	// buffer based interface, must give the same strips
+	std::vector<boost::uint32_t> strip_indices(5, 0); // gets replaced
+	std::vector<std::size_t> strip_lengths;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths);
+	BOOST_CHECK_EQUAL(strip_lengths.size(), strips.size());
+	std::vector<boost::uint32_t>::const_iterator i = strip_indices.begin();
+	std::set<Face> strip_faces;
+	std::size_t n = 0;
+	BOOST_FOREACH(const std::deque<int> & strip, strips) {
+		BOOST_CHECK_EQUAL(strip_lengths[n], strip.size());
+		BOOST_CHECK(std::equal(strip.begin(), strip.end(), i));
+		triangulate(i, i + strip_lengths[n], strip_faces);
+		i += strip_lengths[n++];
+	}
+	BOOST_CHECK(i == strip_indices.end());
+	BOOST_CHECK(strip_faces == faces);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_buffer_16_test)
+{
+	std::vector<boost::uint16_t> indices = grid<boost::uint16_t>(5);
+	std::vector<boost::uint32_t> indices32(indices.begin(), indices.end());
+	std::vector<boost::uint16_t> strip_indices;
+	std::vector<boost::uint32_t> strip_indices32;
+	std::vector<std::size_t> strip_lengths;
+	std::vector<std::size_t> strip_lengths32;
+	stripify(&indices[0], indices.size() / 3, strip_indices, strip_lengths);
+	stripify(&indices32[0], indices.size() / 3, strip_indices32, strip_lengths32);
+	BOOST_CHECK(strip_lengths == strip_lengths32);
+	BOOST_CHECK(std::equal(strip_indices.begin(), strip_indices.end(),
+	                       strip_indices32.begin()));
+	// empty input
+	stripify(&indices[0], 0, strip_indices, strip_lengths);
+	BOOST_CHECK(strip_indices.empty());
+	BOOST_CHECK(strip_lengths.empty());
+}
+
+BOOST_AUTO_TEST_CASE(stripify_batch_test)
+{
+	// meshes of many sizes, including an empty one
+	std::vector<std::vector<boost::uint32_t> > buffers;
+	for (int size = 0; size < 40; size++)
+		buffers.push_back(grid<boost::uint32_t>((size * 7) % 40));
+	std::vector<BatchMesh> meshes;
+	BOOST_FOREACH(const std::vector<boost::uint32_t> & buffer, buffers) {
+		BatchMesh mesh = {buffer.data(), buffer.size() / 3};
+		meshes.push_back(mesh);
+	}
+	std::vector<BatchStrips> strips;
+	stripify_batch(meshes, strips, 4);
+	BOOST_CHECK_EQUAL(strips.size(), meshes.size());
+	// same result as stripifying each mesh separately
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	for (std::size_t i = 0; i < meshes.size(); i++) {
+		stripify(meshes[i].indices, meshes[i].num_triangles,
+		         strip_indices, strip_lengths);
+		BOOST_CHECK(strips[i].indices == strip_indices);
+		BOOST_CHECK(strips[i].lengths == strip_lengths);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(stripify_batch_split_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(30);
+	std::vector<boost::uint32_t> small_indices = grid<boost::uint32_t>(3);
+	BatchMesh mesh = {indices.data(), indices.size() / 3};
+	BatchMesh small_mesh = {small_indices.data(), small_indices.size() / 3};
+	std::vector<BatchMesh> meshes;
+	meshes.push_back(mesh);
+	meshes.push_back(small_mesh);
+	std::vector<BatchStrips> strips;
+	stripify_batch(meshes, strips, 3, 100);
+	BOOST_CHECK_EQUAL(strips.size(), 2);
+	// parts still cover all triangles
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < mesh.num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	std::set<Face> strip_faces;
+	std::vector<boost::uint32_t>::const_iterator i = strips[0].indices.begin();
+	BOOST_FOREACH(std::size_t length, strips[0].lengths) {
+		triangulate(i, i + length, strip_faces);
+		i += length;
+	}
+	BOOST_CHECK(i == strips[0].indices.end());
+	BOOST_CHECK(strip_faces == faces);
+	// small mesh is not split
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(small_mesh.indices, small_mesh.num_triangles,
+	         strip_indices, strip_lengths);
+	BOOST_CHECK(strips[1].indices == strip_indices);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_batch_split_single_strip_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(20);
+	BatchMesh mesh = {indices.data(), indices.size() / 3};
+	std::vector<BatchMesh> meshes(1, mesh);
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < mesh.num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	StripifyOutput outputs[] = {
+		OUTPUT_STITCHED_STRIP, OUTPUT_RESTART_STRIP, OUTPUT_TRIANGLE_LIST
+	};
+	BOOST_FOREACH(StripifyOutput output, outputs) {
+		StripifyOptions options;
+		options.output = output;
+		std::vector<BatchStrips> strips;
+		stripify_batch(meshes, strips, 3, 100, options);
+		// parts are joined into one strip, which covers all faces
+		BOOST_CHECK_EQUAL(strips[0].lengths.size(), 1);
+		BOOST_CHECK_EQUAL(strips[0].lengths[0], strips[0].indices.size());
+		std::set<Face> strip_faces;
+		std::vector<boost::uint32_t>::const_iterator first = strips[0].indices.begin();
+		std::vector<boost::uint32_t>::const_iterator last = strips[0].indices.end();
+		if (output == OUTPUT_STITCHED_STRIP) {
+			triangulate(first, last, strip_faces);
+		} else if (output == OUTPUT_RESTART_STRIP) {
+			while (first < last) {
+				std::vector<boost::uint32_t>::const_iterator end
+				    = std::find(first, last, options.restart_index);
+				triangulate(first, end, strip_faces);
+				first = (end == last) ? end : end + 1;
+			}
+		} else {
+			BOOST_CHECK_EQUAL(strips[0].indices.size(), 3 * mesh.num_triangles);
+			for (; first < last; first += 3)
+				strip_faces.insert(Face(first[0], first[1], first[2]));
+		}
+		BOOST_CHECK(strip_faces == faces);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(stripify_cache_aware_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(30);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths);
+	CacheStats stats = analyze_cache(&strip_indices[0], strip_lengths);
+
+	StripifyOptions options;
+	options.cache_size = 16;
+	std::vector<boost::uint32_t> cache_strip_indices;
+	std::vector<std::size_t> cache_strip_lengths;
+	stripify(&indices[0], num_triangles,
+	         cache_strip_indices, cache_strip_lengths, options);
+	// all faces are still covered, by short strips
+	std::set<Face> strip_faces;
+	std::vector<boost::uint32_t>::const_iterator i = cache_strip_indices.begin();
+	BOOST_FOREACH(std::size_t length, cache_strip_lengths) {
+		// at most ten faces, and one duplicate vertex for winding
+		BOOST_CHECK_LE(length, 13);
+		triangulate(i, i + length, strip_faces);
+		i += length;
+	}
+	BOOST_CHECK(strip_faces == faces);
+	// but they hit the cache a lot more often
+	CacheStats cache_stats = analyze_cache(&cache_strip_indices[0], cache_strip_lengths);
+	BOOST_TEST_MESSAGE("acmr: " << stats.acmr << " -> " << cache_stats.acmr);
+	BOOST_CHECK_EQUAL(cache_stats.num_triangles, num_triangles);
+	BOOST_CHECK_LT(cache_stats.num_misses, stats.num_misses);
+	// and do not depend on the number of threads
+	options.num_threads = 3;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths, options);
+	BOOST_CHECK(strip_indices == cache_strip_indices);
+	BOOST_CHECK(strip_lengths == cache_strip_lengths);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_stitched_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(20);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	StripifyOptions options;
+	options.cache_size = 16; // many short strips
+	std::vector<boost::uint32_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths, options);
+	options.output = OUTPUT_STITCHED_STRIP;
+	std::vector<boost::uint32_t> stitched_indices;
+	std::vector<std::size_t> stitched_lengths;
+	stripify(&indices[0], num_triangles, stitched_indices, stitched_lengths, options);
+	// one strip, covering all faces
+	BOOST_CHECK_EQUAL(stitched_lengths.size(), 1);
+	BOOST_CHECK_EQUAL(stitched_lengths[0], stitched_indices.size());
+	std::set<Face> strip_faces;
+	triangulate(stitched_indices.begin(), stitched_indices.end(), strip_faces);
+	BOOST_CHECK(strip_faces == faces);
+	// at most three extra indices per join
+	BOOST_CHECK_LE(stitched_indices.size(),
+	               strip_indices.size() + 3 * (strip_lengths.size() - 1));
+	CacheStats stats = analyze_cache(&stitched_indices[0], stitched_lengths);
+	BOOST_CHECK_EQUAL(stats.num_triangles, num_triangles);
+	BOOST_CHECK_GT(stats.num_degenerates, 0);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_restart_test)
+{
+	std::vector<boost::uint16_t> indices = grid<boost::uint16_t>(20);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	StripifyOptions options;
+	options.cache_size = 16; // many short strips
+	options.output = OUTPUT_RESTART_STRIP;
+	std::vector<boost::uint16_t> strip_indices;
+	std::vector<std::size_t> strip_lengths;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths, options);
+	BOOST_CHECK_EQUAL(strip_lengths.size(), 1);
+	BOOST_CHECK_EQUAL(strip_lengths[0], strip_indices.size());
+	// strips between restarts have no degenerate faces, and
+	// together have all faces
+	std::set<Face> strip_faces;
+	std::size_t num_strip_faces = 0;
+	std::vector<boost::uint16_t>::iterator first = strip_indices.begin();
+	while (first != strip_indices.end()) {
+		std::vector<boost::uint16_t>::iterator last
+		    = std::find(first, strip_indices.end(), boost::uint16_t(0xFFFF));
+		BOOST_CHECK_GE(last - first, 3);
+		num_strip_faces += (last - first) - 2;
+		triangulate(first, last, strip_faces);
+		first = (last == strip_indices.end()) ? last : last + 1;
+	}
+	BOOST_CHECK_EQUAL(num_strip_faces, faces.size());
+	BOOST_CHECK(strip_faces == faces);
+	CacheAnalysisOptions analysis_options;
+	analysis_options.primitive_restart = true;
+	CacheStats stats = analyze_cache(&strip_indices[0], strip_lengths, analysis_options);
+	BOOST_CHECK_EQUAL(stats.num_triangles, num_triangles);
+	BOOST_CHECK_EQUAL(stats.num_degenerates, 0);
+	BOOST_CHECK_GT(stats.num_restarts, 0);
+	// vertices must not collide with the restart index
+	options.restart_index = indices[5];
+	BOOST_CHECK_THROW(stripify(&indices[0], num_triangles,
+	                           strip_indices, strip_lengths, options),
+	                  std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(stripify_triangle_list_test)
+{
+	std::vector<boost::uint16_t> indices = grid<boost::uint16_t>(20);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	StripifyOptions options;
+	options.output = OUTPUT_TRIANGLE_LIST;
+	std::vector<boost::uint16_t> list_indices;
+	std::vector<std::size_t> list_lengths;
+	stripify(&indices[0], num_triangles, list_indices, list_lengths, options);
+	// a single list with all faces, in their original winding
+	BOOST_CHECK_EQUAL(list_lengths.size(), 1);
+	BOOST_CHECK_EQUAL(list_indices.size(), indices.size());
+	std::set<Face> list_faces;
+	for (std::size_t i = 0; i < list_indices.size(); i += 3)
+		list_faces.insert(Face(list_indices[i], list_indices[i + 1], list_indices[i + 2]));
+	BOOST_CHECK(list_faces == faces);
+	// list based interface gives the same list
+	std::list<std::list<int> > triangles;
+	for (std::size_t i = 0; i < num_triangles; i++) {
+		std::list<int> triangle(&indices[3 * i], &indices[3 * i + 3]);
+		triangles.push_back(triangle);
+	}
+	std::list<std::deque<int> > lists = stripify(triangles, options);
+	BOOST_CHECK_EQUAL(lists.size(), 1);
+	BOOST_CHECK(std::equal(list_indices.begin(), list_indices.end(),
+	                       lists.front().begin()));
+	// empty input
+	stripify(&indices[0], 0, list_indices, list_lengths, options);
+	BOOST_CHECK(list_indices.empty());
+	BOOST_CHECK(list_lengths.empty());
+}
+
+BOOST_AUTO_TEST_CASE(stripify_mesh_samples_test)
+{
+	std::vector<boost::uint32_t> indices = grid<boost::uint32_t>(20);
+	std::size_t num_triangles = indices.size() / 3;
+	std::set<Face> faces;
+	for (std::size_t i = 0; i < num_triangles; i++)
+		faces.insert(Face(indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]));
+	// a prebuilt mesh gives the same strips as its index buffer
+	std::vector<boost::uint32_t> strip_indices, mesh_strip_indices;
+	std::vector<std::size_t> strip_lengths, mesh_strip_lengths;
+	stripify(&indices[0], num_triangles, strip_indices, strip_lengths);
+	MeshPtr mesh(new Mesh(&indices[0], num_triangles));
+	stripify(mesh, mesh_strip_indices, mesh_strip_lengths);
+	BOOST_CHECK(mesh_strip_indices == strip_indices);
+	BOOST_CHECK(mesh_strip_lengths == strip_lengths);
+	// any number of samples covers all faces
+	StripifyOptions options;
+	int samples[] = {1, 3, 30};
+	BOOST_FOREACH(int num_samples, samples) {
+		options.num_samples = num_samples;
+		stripify(mesh, strip_indices, strip_lengths, options);
+		std::set<Face> strip_faces;
+		std::vector<boost::uint32_t>::const_iterator i = strip_indices.begin();
+		BOOST_FOREACH(std::size_t length, strip_lengths) {
+			triangulate(i, i + length, strip_faces);
+			i += length;
+		}
+		BOOST_CHECK(strip_faces == faces);
+	}
+	options.num_samples = 0;
+	BOOST_CHECK_THROW(stripify(mesh, strip_indices, strip_lengths, options), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_CASE(stripify_concurrent_test)
+{
+	// every output, each on meshes of several sizes
+	StripifyOutput outputs[] = {
+		OUTPUT_STRIPS, OUTPUT_STITCHED_STRIP, OUTPUT_RESTART_STRIP, OUTPUT_TRIANGLE_LIST
+	};
+	std::vector<std::vector<boost::uint32_t> > buffers;
+	std::vector<StripifyOptions> options;
+	BOOST_FOREACH(StripifyOutput output, outputs) {
+		for (int size = 5; size < 30; size += 6) {
+			buffers.push_back(grid<boost::uint32_t>(size));
+			StripifyOptions mesh_options;
+			mesh_options.output = output;
+			mesh_options.num_threads = size % 2 + 1;
+			options.push_back(mesh_options);
+		}
+	}
+	std::vector<BatchStrips> expected(buffers.size());
+	for (std::size_t i = 0; i < buffers.size(); i++)
+		stripify(buffers[i].data(), buffers[i].size() / 3,
+		         expected[i].indices, expected[i].lengths, options[i]);
+	// stripify all meshes again from several threads at once
+	std::vector<BatchStrips> strips(buffers.size());
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < 4; t++) {
+		threads.push_back(std::thread([&, t]() {
+			for (std::size_t i = t; i < buffers.size(); i += 4)
+				stripify(buffers[i].data(), buffers[i].size() / 3,
+				         strips[i].indices, strips[i].lengths, options[i]);
+		}));
+	}
+	BOOST_FOREACH(std::thread & thread, threads) thread.join();
+	for (std::size_t i = 0; i < buffers.size(); i++) {
+		BOOST_CHECK(strips[i].indices == expected[i].indices);
+		BOOST_CHECK(strips[i].lengths == expected[i].lengths);
+	}
+}
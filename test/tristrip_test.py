@@ -1,6 +1,6 @@
 """Tests for pytristrip.
 
->>> import pytristrip
+>>> import tristrip as pytristrip
 >>> triangles = [(0,1,4),(1,2,4),(2,3,4),(3,0,4)]
 >>> strips = pytristrip.stripify(triangles)
 >>> _check_strips(triangles, strips)
@@ -25,6 +25,23 @@
 >>> triangles = [(1, 2, 3), (4, 5, 6), (6, 5, 7), (8, 5, 9), (4, 10, 9), (8, 3, 11), (8, 10, 3), (12, 13, 6), (14, 2, 15), (16, 13, 15), (16, 2, 3), (3, 2, 1)]
 >>> strips = pytristrip.stripify(triangles)
 >>> _check_strips(triangles, strips) # NvTriStrip gives wrong result
+>>> import numpy
+>>> triangles = numpy.array([(0,1,4),(1,2,4),(2,3,4),(3,0,4)], dtype=numpy.uint16)
+>>> indices, offsets = pytristrip.stripify(triangles)
+>>> indices.dtype
+dtype('uint16')
+>>> _check_strips([tuple(t) for t in triangles.tolist()], _split_strips(indices, offsets))
+>>> triangles = numpy.array([(0, 1, 2), (2, 1, 0), (1, 2, 3)], dtype=numpy.uint32)
+>>> indices, offsets = pytristrip.stripify(triangles)
+>>> _check_strips([tuple(t) for t in triangles.tolist()], _split_strips(indices, offsets))
+>>> pytristrip.stripify(numpy.zeros((0, 3), dtype=numpy.uint32))
+(array([], dtype=uint32), array([0]))
+>>> meshes = [[(0,1,4),(1,2,4),(2,3,4),(3,0,4)], numpy.array([(0, 1, 2), (0, 1, 3)], dtype=numpy.uint32), []]
+>>> results = pytristrip.stripify_many(meshes, threads=2)
+>>> len(results)
+3
+>>> for triangles, (indices, offsets) in zip(meshes, results):
+...     _check_strips([tuple(t) for t in numpy.array(triangles).tolist()], _split_strips(indices, offsets))
 """
 
 # ***** BEGIN LICENSE BLOCK *****
@@ -78,17 +95,22 @@ def _triangulate(strips):
 
     for strip in strips:
         if len(strip) < 3: continue # skip empty strips
-        i = strip.__iter__()
+        i = iter(strip)
         j = False
-        t1, t2 = i.next(), i.next()
-        for k in xrange(2, len(strip)):
+        t1, t2 = next(i), next(i)
+        for k in range(2, len(strip)):
             j = not j
-            t0, t1, t2 = t1, t2, i.next()
+            t0, t1, t2 = t1, t2, next(i)
             if t0 == t1 or t1 == t2 or t2 == t0: continue
             triangles.append((t0, t1, t2) if j else (t0, t2, t1))
 
     return triangles
 
+def _split_strips(indices, offsets):
+    """Strips of a flat index array and offsets, as lists."""
+    return [indices[offsets[i]:offsets[i + 1]].tolist()
+            for i in range(len(offsets) - 1)]
+
 def _check_strips(triangles, strips):
     """Check that triangles and strips describe the same geometry."""
     strips_triangles = _triangulate(strips)
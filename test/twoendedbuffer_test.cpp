@@ -0,0 +1,97 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+
+#include "twoendedbuffer.hpp"
+
+BOOST_AUTO_TEST_SUITE(twoendedbuffer_test_suite)
+
+BOOST_AUTO_TEST_CASE(twoendedbuffer_push_pop_test)
+{
+	// compare against a deque, growing at both ends
+	TwoEndedBuffer<int> b;
+	std::deque<int> d;
+	BOOST_CHECK(b.empty());
+	for (int i = 0; i < 100; i++) {
+		if (i % 3) {
+			b.push_back(i);
+			d.push_back(i);
+		} else {
+			b.push_front(i);
+			d.push_front(i);
+		}
+		BOOST_CHECK_EQUAL(b.size(), d.size());
+		BOOST_CHECK_EQUAL(b.front(), d.front());
+		BOOST_CHECK_EQUAL(b.back(), d.back());
+	}
+	BOOST_CHECK_EQUAL_COLLECTIONS(b.begin(), b.end(), d.begin(), d.end());
+	BOOST_CHECK_EQUAL_COLLECTIONS(b.rbegin(), b.rend(), d.rbegin(), d.rend());
+	b.pop_front();
+	d.pop_front();
+	b.pop_back();
+	d.pop_back();
+	BOOST_CHECK_EQUAL_COLLECTIONS(b.begin(), b.end(), d.begin(), d.end());
+	BOOST_CHECK_EQUAL(b[10], d[10]);
+	b.clear();
+	BOOST_CHECK(b.empty());
+	b.push_front(5);
+	b.push_back(6);
+	BOOST_CHECK_EQUAL(b.size(), 2);
+	BOOST_CHECK_EQUAL(b.front(), 5);
+	BOOST_CHECK_EQUAL(b.back(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(twoendedbuffer_copy_test)
+{
+	TwoEndedBuffer<int> b;
+	for (int i = 0; i < 20; i++) b.push_front(i);
+	TwoEndedBuffer<int> c(b);
+	BOOST_CHECK_EQUAL_COLLECTIONS(b.begin(), b.end(), c.begin(), c.end());
+	// copies are independent
+	c.push_front(-1);
+	BOOST_CHECK_EQUAL(b.size(), 20);
+	BOOST_CHECK_EQUAL(c.size(), 21);
+	b = c;
+	BOOST_CHECK_EQUAL_COLLECTIONS(b.begin(), b.end(), c.begin(), c.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <new>
+
+#include "vertexcache.hpp"
+
+BOOST_AUTO_TEST_SUITE(vertexcache_test_suite)
+
+BOOST_AUTO_TEST_CASE(vertexcache_fifo_test)
+{
+	VertexCache cache(3);
+	BOOST_CHECK_EQUAL(cache.size(), 3);
+	BOOST_CHECK(!cache.contains(0));
+	BOOST_CHECK(!cache.add(0));
+	BOOST_CHECK(!cache.add(1));
+	BOOST_CHECK(!cache.add(2));
+	// hits do not change the order of eviction
+	BOOST_CHECK(cache.add(0));
+	BOOST_CHECK(!cache.add(3));
+	BOOST_CHECK(!cache.contains(0));
+	BOOST_CHECK(cache.contains(1));
+	BOOST_CHECK(cache.contains(2));
+	BOOST_CHECK(cache.contains(3));
+	BOOST_CHECK(!cache.add(4));
+	BOOST_CHECK(!cache.contains(1));
+	cache.clear();
+	BOOST_CHECK(!cache.contains(3));
+	BOOST_CHECK(!cache.add(3));
+}
+
+BOOST_AUTO_TEST_CASE(vertexcache_lru_test)
+{
+	VertexCache cache(3, CACHE_LRU);
+	BOOST_CHECK(!cache.add(0));
+	BOOST_CHECK(!cache.add(1));
+	BOOST_CHECK(!cache.add(2));
+	// hits move the vertex to the back of the line
+	BOOST_CHECK(cache.add(0));
+	BOOST_CHECK(!cache.add(3));
+	BOOST_CHECK(cache.contains(0));
+	BOOST_CHECK(!cache.contains(1));
+	BOOST_CHECK(cache.add(2));
+	BOOST_CHECK(!cache.add(4));
+	BOOST_CHECK(!cache.contains(0));
+	BOOST_CHECK(cache.contains(2));
+	BOOST_CHECK(cache.contains(3));
+	BOOST_CHECK(cache.contains(4));
+	// also before the cache is full
+	VertexCache small(3, CACHE_LRU);
+	small.add(5);
+	small.add(6);
+	small.add(5);
+	small.add(7);
+	small.add(8);
+	BOOST_CHECK(small.contains(5));
+	BOOST_CHECK(!small.contains(6));
+}
+
+BOOST_AUTO_TEST_CASE(vertexcache_copy_test)
+{
+	VertexCache cache(2);
+	cache.add(5);
+	VertexCache other(cache);
+	other.add(6);
+	other.add(7);
+	BOOST_CHECK(cache.contains(5));
+	BOOST_CHECK(!cache.contains(6));
+	BOOST_CHECK(!other.contains(5));
+}
+
+BOOST_AUTO_TEST_CASE(vertexcache_resource_test)
+{
+	// an arena which cannot grow, so any allocation outside it
+	// throws
+	char buffer[256];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+	        std::pmr::null_memory_resource());
+	VertexCache cache(4, CACHE_FIFO, &arena);
+	cache.add(5);
+	VertexCache other(cache, &arena);
+	other.add(6);
+	BOOST_CHECK(other.contains(5));
+	BOOST_CHECK(other.contains(6));
+	BOOST_CHECK(!cache.contains(6));
+	VertexCache large(1000);
+	BOOST_CHECK_THROW(VertexCache(large, &arena), std::bad_alloc);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
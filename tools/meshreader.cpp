@@ -0,0 +1,326 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "meshreader.hpp"
+
+typedef std::vector<boost::uint32_t> Indices;
+
+//! Append polygon to indices, as a fan of triangles.
+static void add_polygon(Indices & indices, const std::vector<boost::int64_t> & polygon)
+{
+	if (polygon.size() < 3)
+		throw std::runtime_error("Face with less than three vertices.");
+	for (std::size_t i = 0; i < polygon.size(); i++) {
+		if ((polygon[i] < 0) || (polygon[i] >= 0xFFFFFFFF))
+			throw std::runtime_error("Vertex index out of range.");
+	}
+	for (std::size_t i = 1; i + 1 < polygon.size(); i++) {
+		indices.push_back(boost::uint32_t(polygon[0]));
+		indices.push_back(boost::uint32_t(polygon[i]));
+		indices.push_back(boost::uint32_t(polygon[i + 1]));
+	}
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ OBJ
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static bool is_space(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+void parse_obj(const char *p, const char *end, Indices & indices)
+{
+	std::size_t first = indices.size();
+	boost::int64_t num_vertices = 0;
+	std::vector<boost::int64_t> polygon;
+	while (p < end) {
+		while ((p < end) && is_space(*p)) p++;
+		if ((end - p >= 2) && (p[0] == 'v') && is_space(p[1])) {
+			num_vertices++;
+		} else if ((end - p >= 2) && (p[0] == 'f') && is_space(p[1])) {
+			p += 2;
+			polygon.clear();
+			while (true) {
+				while ((p < end) && is_space(*p)) p++;
+				if ((p == end) || (*p == '\n') || (*p == '#')) break;
+				bool negative = (*p == '-');
+				if (negative || (*p == '+')) p++;
+				if ((p == end) || (*p < '0') || (*p > '9'))
+					throw std::runtime_error("Invalid face in OBJ file.");
+				boost::int64_t value = 0;
+				while ((p < end) && (*p >= '0') && (*p <= '9') && (value < 0xFFFFFFFFLL))
+					value = 10 * value + (*p++ - '0');
+				// skip texture and normal index
+				while ((p < end) && !is_space(*p) && (*p != '\n')) p++;
+				polygon.push_back(negative ? num_vertices - value : value - 1);
+			}
+			add_polygon(indices, polygon);
+		}
+		while ((p < end) && (*p != '\n')) p++;
+		p++;
+	}
+	// faces may refer to vertices defined after them, so only
+	// now all indices can be checked
+	for (std::size_t i = first; i < indices.size(); i++) {
+		if (indices[i] >= num_vertices)
+			throw std::runtime_error("Vertex index out of range.");
+	}
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ PLY
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Type of a PLY property, or of the count of a list property.
+struct PlyType {
+	const char *name;
+	const char *alias;
+	int size;
+	bool is_signed;
+	bool is_float;
+};
+
+static const PlyType PLY_TYPES[] = {
+	{"char", "int8", 1, true, false},
+	{"uchar", "uint8", 1, false, false},
+	{"short", "int16", 2, true, false},
+	{"ushort", "uint16", 2, false, false},
+	{"int", "int32", 4, true, false},
+	{"uint", "uint32", 4, false, false},
+	{"float", "float32", 4, true, true},
+	{"double", "float64", 8, true, true}
+};
+
+static const PlyType *find_ply_type(const std::string & name)
+{
+	for (std::size_t i = 0; i < sizeof(PLY_TYPES) / sizeof(PLY_TYPES[0]); i++) {
+		if ((name == PLY_TYPES[i].name) || (name == PLY_TYPES[i].alias))
+			return &PLY_TYPES[i];
+	}
+	throw std::runtime_error("Unknown PLY type " + name + ".");
+}
+
+struct PlyProperty {
+	std::string name;
+	const PlyType *type;
+	//! Type of the count of a list, or null if not a list.
+	const PlyType *count_type;
+};
+
+struct PlyElement {
+	std::string name;
+	std::size_t count;
+	std::vector<PlyProperty> properties;
+};
+
+//! Reads integers from the body of a binary PLY file. Values are
+//! assembled byte by byte, so only big endian files need swapping,
+//! whatever the native byte order.
+class PlyReader
+{
+public:
+	PlyReader(const char *p, const char *end, bool swap)
+		: p(p), end(end), swap(swap) {};
+
+	//! Read an integer of given type.
+	boost::int64_t read(const PlyType & type) {
+		if (type.is_float)
+			throw std::runtime_error("PLY list with floating point count or index.");
+		const char *data = skip(type.size);
+		unsigned char bytes[4];
+		for (int i = 0; i < type.size; i++)
+			bytes[i] = data[swap ? type.size - 1 - i : i];
+		boost::uint32_t value = 0;
+		for (int i = type.size - 1; i >= 0; i--)
+			value = (value << 8) | bytes[i];
+		if (type.is_signed) {
+			int shift = 32 - 8 * type.size;
+			return boost::int64_t(boost::int32_t(value << shift) >> shift);
+		}
+		return value;
+	};
+
+	//! Skip size bytes, and return where they start.
+	const char *skip(std::size_t size) {
+		if (std::size_t(end - p) < size)
+			throw std::runtime_error("Unexpected end of PLY file.");
+		const char *data = p;
+		p += size;
+		return data;
+	};
+
+private:
+	const char *p;
+	const char *end;
+	bool swap;
+};
+
+//! Read the next line of the PLY header.
+static std::string read_ply_line(const char *& p, const char *end)
+{
+	const char *start = p;
+	while ((p < end) && (*p != '\n')) p++;
+	if (p == end)
+		throw std::runtime_error("Unexpected end of PLY header.");
+	const char *stop = p++;
+	if ((stop > start) && (stop[-1] == '\r')) stop--;
+	return std::string(start, stop);
+}
+
+//! Split line at spaces.
+static std::vector<std::string> split_words(const std::string & line)
+{
+	std::vector<std::string> words;
+	std::size_t i = 0;
+	while (i < line.size()) {
+		while ((i < line.size()) && is_space(line[i])) i++;
+		std::size_t start = i;
+		while ((i < line.size()) && !is_space(line[i])) i++;
+		if (i > start) words.push_back(line.substr(start, i - start));
+	}
+	return words;
+}
+
+void parse_ply(const char *p, const char *end, Indices & indices)
+{
+	if (read_ply_line(p, end) != "ply")
+		throw std::runtime_error("Not a PLY file.");
+	bool little_endian = true;
+	std::vector<PlyElement> elements;
+	while (true) {
+		std::vector<std::string> words = split_words(read_ply_line(p, end));
+		if (words.empty()) continue;
+		if (words[0] == "end_header") break;
+		if (words[0] == "format") {
+			if ((words.size() > 1) && (words[1] == "binary_little_endian"))
+				little_endian = true;
+			else if ((words.size() > 1) && (words[1] == "binary_big_endian"))
+				little_endian = false;
+			else
+				throw std::runtime_error("Only binary PLY files are supported.");
+		} else if (words[0] == "element") {
+			if (words.size() != 3)
+				throw std::runtime_error("Invalid PLY element.");
+			PlyElement element;
+			element.name = words[1];
+			element.count = std::strtoull(words[2].c_str(), 0, 10);
+			elements.push_back(element);
+		} else if (words[0] == "property") {
+			if (elements.empty())
+				throw std::runtime_error("PLY property outside of element.");
+			PlyProperty property;
+			if ((words.size() == 5) && (words[1] == "list")) {
+				property.count_type = find_ply_type(words[2]);
+				property.type = find_ply_type(words[3]);
+				property.name = words[4];
+			} else if (words.size() == 3) {
+				property.count_type = 0;
+				property.type = find_ply_type(words[1]);
+				property.name = words[2];
+			} else {
+				throw std::runtime_error("Invalid PLY property.");
+			}
+			elements.back().properties.push_back(property);
+		}
+		// comment and obj_info lines are ignored
+	}
+	PlyReader reader(p, end, !little_endian);
+	std::size_t first = indices.size();
+	std::size_t num_vertices = 0;
+	for (std::size_t e = 0; e < elements.size(); e++) {
+		if (elements[e].name == "vertex") num_vertices = elements[e].count;
+		if ((elements[e].name != "face") || !elements[e].count) continue;
+		bool found = false;
+		for (std::size_t i = 0; i < elements[e].properties.size(); i++) {
+			const PlyProperty & property = elements[e].properties[i];
+			if (property.count_type && ((property.name == "vertex_indices")
+			                            || (property.name == "vertex_index")))
+				found = true;
+		}
+		if (!found)
+			throw std::runtime_error("PLY faces have no vertex_indices.");
+	}
+	std::vector<boost::int64_t> polygon;
+	for (std::size_t e = 0; e < elements.size(); e++) {
+		const PlyElement & element = elements[e];
+		// fixed size elements are skipped at once
+		std::size_t record_size = 0;
+		bool fixed = true;
+		for (std::size_t i = 0; i < element.properties.size(); i++) {
+			if (element.properties[i].count_type) fixed = false;
+			record_size += element.properties[i].type->size;
+		}
+		if (fixed && (element.name != "face")) {
+			if (record_size && (element.count > std::size_t(-1) / record_size))
+				throw std::runtime_error("Unexpected end of PLY file.");
+			reader.skip(element.count * record_size);
+			continue;
+		}
+		for (std::size_t r = 0; r < element.count; r++) {
+			for (std::size_t i = 0; i < element.properties.size(); i++) {
+				const PlyProperty & property = element.properties[i];
+				if (!property.count_type) {
+					reader.skip(property.type->size);
+					continue;
+				}
+				boost::int64_t count = reader.read(*property.count_type);
+				if (count < 0)
+					throw std::runtime_error("Negative PLY list size.");
+				if ((element.name == "face")
+				    && ((property.name == "vertex_indices")
+				        || (property.name == "vertex_index"))) {
+					polygon.clear();
+					for (boost::int64_t k = 0; k < count; k++)
+						polygon.push_back(reader.read(*property.type));
+					add_polygon(indices, polygon);
+				} else {
+					reader.skip(std::size_t(count) * property.type->size);
+				}
+			}
+		}
+	}
+	for (std::size_t i = first; i < indices.size(); i++) {
+		if (indices[i] >= num_vertices)
+			throw std::runtime_error("Vertex index out of range.");
+	}
+}
@@ -0,0 +1,63 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Readers for the faces of OBJ and PLY files.
+
+#ifndef TRISTRIP_MESHREADER_HPP
+#define TRISTRIP_MESHREADER_HPP
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+//! Parse the faces of an OBJ file in memory, from p up to end, and
+//! append them to indices, three per triangle. Only 'v' and 'f'
+//! lines are looked at: texture and normal indices of faces are
+//! skipped, negative indices count back from the last vertex, and
+//! polygons are split into triangle fans. Throws std::runtime_error
+//! if a face is invalid or refers to a vertex that does not exist.
+void parse_obj(const char *p, const char *end, std::vector<boost::uint32_t> & indices);
+
+//! Parse the faces of a binary PLY file in memory, from the
+//! vertex_indices or vertex_index list of the face element, and
+//! append them to indices like parse_obj. All other elements and
+//! properties are skipped. Throws std::runtime_error if the file is
+//! not a valid binary PLY file, or if a face refers to a vertex that
+//! does not exist.
+void parse_ply(const char *p, const char *end, std::vector<boost::uint32_t> & indices);
+
+#endif
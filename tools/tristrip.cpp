@@ -0,0 +1,352 @@
+/*
+
+Copyright (c) 2007-2009, Python File Format Interface
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+   * Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above
+     copyright notice, this list of conditions and the following
+     disclaimer in the documentation and/or other materials provided
+     with the distribution.
+
+   * Neither the name of the Python File Format Interface
+     project nor the names of its contributors may be used to endorse
+     or promote products derived from this software without specific
+     prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Command line stripifier for OBJ, PLY, and index buffer files.
+//
+// Usage: tristrip [options] input
+//
+// Options:
+//   --mode MODE         strips, stitched, restart, or list (default strips)
+//   --samples N         start faces tried per round (default 10)
+//   --threads N         threads for experiments, 0 for all cores (default 1)
+//   --cache-size N      optimize for a vertex cache of N entries (default off)
+//   --restart-index N   primitive restart index (default 4294967295)
+//   -o FILE             write the result; text if FILE ends in .txt,
+//                       otherwise an index buffer file
+//
+// The input is a Wavefront OBJ file (.obj), a binary PLY file (.ply),
+// or else an index buffer file. Polygons are split into triangle
+// fans. Prints the time taken by each phase, the counters of the
+// stripifier, and statistics of the result.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "cacheanalysis.hpp"
+#include "indexbuffer.hpp"
+#include "meshreader.hpp"
+#include "stripifystats.hpp"
+#include "trianglemesh.hpp"
+#include "tristrip.hpp"
+
+typedef std::vector<boost::uint32_t> Indices;
+
+typedef std::chrono::steady_clock Clock;
+
+//! Seconds since start.
+static double get_seconds(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//! Whether name ends with suffix, ignoring case.
+static bool has_suffix(const std::string & name, const char *suffix)
+{
+	std::size_t size = std::strlen(suffix);
+	if (name.size() < size) return false;
+	for (std::size_t i = 0; i < size; i++) {
+		char c = name[name.size() - size + i];
+		if ((c >= 'A') && (c <= 'Z')) c += 'a' - 'A';
+		if (c != suffix[i]) return false;
+	}
+	return true;
+}
+
+//! Read the whole file into memory.
+static void read_file(const std::string & filename, std::vector<char> & data)
+{
+	FILE *file = std::fopen(filename.c_str(), "rb");
+	if (!file)
+		throw std::runtime_error("Cannot open " + filename + ".");
+	char buffer[65536];
+	std::size_t size;
+	while ((size = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + size);
+	bool failed = std::ferror(file);
+	std::fclose(file);
+	if (failed)
+		throw std::runtime_error("Cannot read " + filename + ".");
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ Output
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Write strips as text: each strip on a line, or for a triangle
+//! list, each triangle on a line.
+static void write_text(const std::string & filename, const StripifyOptions & options,
+                       const Indices & indices, const std::vector<std::size_t> & lengths)
+{
+	FILE *file = std::fopen(filename.c_str(), "w");
+	if (!file)
+		throw std::runtime_error("Cannot open " + filename + ".");
+	std::size_t first = 0;
+	for (std::size_t s = 0; s < lengths.size(); s++) {
+		std::size_t line = (options.output == OUTPUT_TRIANGLE_LIST) ? 3 : lengths[s];
+		for (std::size_t i = 0; i < lengths[s]; i++) {
+			std::fprintf(file, ((i % line) + 1 == line) ? "%lu\n" : "%lu ",
+			             (unsigned long)indices[first + i]);
+		}
+		first += lengths[s];
+	}
+	bool failed = std::ferror(file);
+	if ((std::fclose(file) != 0) || failed)
+		throw std::runtime_error("Cannot write " + filename + ".");
+}
+
+//! Write strips in the format of filename.
+static void write_output(const std::string & filename, const StripifyOptions & options,
+                         const Indices & indices, const std::vector<std::size_t> & lengths)
+{
+	if (has_suffix(filename, ".txt")) {
+		write_text(filename, options, indices, lengths);
+		return;
+	}
+	IndexBufferContent content = CONTENT_STRIPS;
+	if (options.output == OUTPUT_STITCHED_STRIP)
+		content = CONTENT_STITCHED_STRIP;
+	else if (options.output == OUTPUT_RESTART_STRIP)
+		content = CONTENT_RESTART_STRIP;
+	else if (options.output == OUTPUT_TRIANGLE_LIST)
+		content = CONTENT_TRIANGLES;
+	write_index_buffer(filename, content, 4, indices.data(), indices.size(),
+	                   lengths, options.restart_index);
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//~ Main
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//! Parse numeric argument of option.
+static long parse_number(int argc, char **argv, int & i)
+{
+	if (i + 1 == argc)
+		throw std::runtime_error(std::string("Missing value for ") + argv[i] + ".");
+	return std::atol(argv[++i]);
+}
+
+//! Parse unsigned 32 bit argument of option.
+static boost::uint32_t parse_unsigned(int argc, char **argv, int & i)
+{
+	if (i + 1 == argc)
+		throw std::runtime_error(std::string("Missing value for ") + argv[i] + ".");
+	return boost::uint32_t(std::strtoul(argv[++i], 0, 10));
+}
+
+//! Parse output mode.
+static StripifyOutput parse_mode(int argc, char **argv, int & i)
+{
+	if (i + 1 == argc)
+		throw std::runtime_error(std::string("Missing value for ") + argv[i] + ".");
+	const char *mode = argv[++i];
+	if (std::strcmp(mode, "strips") == 0) return OUTPUT_STRIPS;
+	if (std::strcmp(mode, "stitched") == 0) return OUTPUT_STITCHED_STRIP;
+	if (std::strcmp(mode, "restart") == 0) return OUTPUT_RESTART_STRIP;
+	if (std::strcmp(mode, "list") == 0) return OUTPUT_TRIANGLE_LIST;
+	throw std::runtime_error(std::string("Unknown mode ") + mode + ".");
+}
+
+static void print_phase(const char *name, double seconds)
+{
+	std::printf("%-12s %10.3f s\n", name, seconds);
+}
+
+//! Print number of strips with 1, 2 to 3, 4 to 7, ... faces.
+static void print_histogram(const std::vector<std::size_t> & histogram)
+{
+	std::printf("strip faces\n");
+	for (std::size_t first = 1; first < histogram.size(); first *= 2) {
+		std::size_t last = std::min(2 * first, histogram.size());
+		std::size_t num_strips = 0;
+		for (std::size_t i = first; i < last; i++) num_strips += histogram[i];
+		char name[32];
+		std::snprintf(name, sizeof(name), "  %lu-%lu",
+		              (unsigned long)first, (unsigned long)(2 * first - 1));
+		std::printf("%-12s %10lu\n", name, (unsigned long)num_strips);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	StripifyOptions options;
+	std::string input;
+	std::string output;
+	try {
+		for (int i = 1; i < argc; i++) {
+			if (std::strcmp(argv[i], "--mode") == 0) {
+				options.output = parse_mode(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--samples") == 0) {
+				options.num_samples = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--threads") == 0) {
+				options.num_threads = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--cache-size") == 0) {
+				options.cache_size = parse_number(argc, argv, i);
+			} else if (std::strcmp(argv[i], "--restart-index") == 0) {
+				options.restart_index = parse_unsigned(argc, argv, i);
+			} else if (std::strcmp(argv[i], "-o") == 0) {
+				if (i + 1 == argc)
+					throw std::runtime_error("Missing value for -o.");
+				output = argv[++i];
+			} else if ((argv[i][0] == '-') || !input.empty()) {
+				throw std::runtime_error(std::string("Unknown argument ") + argv[i] + ".");
+			} else {
+				input = argv[i];
+			}
+		}
+		if (input.empty())
+			throw std::runtime_error("Missing input file.");
+	} catch (const std::runtime_error & e) {
+		std::fprintf(stderr, "%s\nUsage: %s [--mode strips|stitched|restart|list] [--samples N] [--threads N] [--cache-size N] [--restart-index N] [-o FILE] input\n",
+		             e.what(), argv[0]);
+		return 1;
+	}
+	try {
+		Clock::time_point total_start = Clock::now();
+		// read and parse the input
+		std::size_t num_triangles;
+		double read_seconds = 0.0;
+		double parse_seconds = 0.0;
+		double mesh_seconds;
+		Indices indices;
+		MeshPtr mesh;
+		StripifyStats stats;
+		options.stats = &stats;
+		Clock::time_point start = Clock::now();
+		if (has_suffix(input, ".obj") || has_suffix(input, ".ply")) {
+			std::vector<char> data;
+			read_file(input, data);
+			read_seconds = get_seconds(start);
+			start = Clock::now();
+			if (has_suffix(input, ".obj"))
+				parse_obj(data.data(), data.data() + data.size(), indices);
+			else
+				parse_ply(data.data(), data.data() + data.size(), indices);
+			parse_seconds = get_seconds(start);
+			num_triangles = indices.size() / 3;
+			start = Clock::now();
+			mesh = MeshPtr(new Mesh(indices.data(), num_triangles, &stats));
+			mesh_seconds = get_seconds(start);
+		} else {
+			// build the mesh straight from the mapped file
+			IndexBufferFile file(input);
+			const IndexBufferHeader & header = file.get_header();
+			if ((header.content != CONTENT_TRIANGLES) || (header.num_indices % 3))
+				throw std::runtime_error("Only triangles can be stripified.");
+			read_seconds = get_seconds(start);
+			// trust only the number of indices, which is checked
+			// against the size of the file
+			num_triangles = header.num_indices / 3;
+			start = Clock::now();
+			if (header.index_size == 2)
+				mesh = MeshPtr(new Mesh(file.get_indices<boost::uint16_t>(), num_triangles, &stats));
+			else
+				mesh = MeshPtr(new Mesh(file.get_indices<boost::uint32_t>(), num_triangles, &stats));
+			mesh_seconds = get_seconds(start);
+		}
+		// stripify
+		start = Clock::now();
+		Indices strip_indices;
+		std::vector<std::size_t> strip_lengths;
+		stripify(mesh, strip_indices, strip_lengths, options);
+		double stripify_seconds = get_seconds(start);
+		// write the result
+		double write_seconds = 0.0;
+		if (!output.empty()) {
+			start = Clock::now();
+			write_output(output, options, strip_indices, strip_lengths);
+			write_seconds = get_seconds(start);
+		}
+		double total_seconds = get_seconds(total_start);
+		// quality of the result, through a FIFO vertex cache
+		CacheAnalysisOptions analysis;
+		if (options.output == OUTPUT_TRIANGLE_LIST)
+			analysis.primitive = PRIMITIVE_TRIANGLE_LIST;
+		if (options.cache_size)
+			analysis.cache_size = options.cache_size;
+		analysis.primitive_restart = (options.output == OUTPUT_RESTART_STRIP);
+		analysis.restart_index = options.restart_index;
+		CacheStats cache_stats = analyze_cache(strip_indices.data(), strip_lengths, analysis);
+		print_phase("read", read_seconds);
+		print_phase("parse", parse_seconds);
+		print_phase("mesh", mesh_seconds);
+		print_phase("  faces", stats.face_seconds);
+		print_phase("  adjacency", stats.adjacency_seconds);
+		print_phase("stripify", stripify_seconds);
+		if (options.output != OUTPUT_TRIANGLE_LIST) {
+			print_phase("  reset", stats.reset_point_seconds);
+			print_phase("  experiment", stats.experiment_seconds);
+			print_phase("  commit", stats.commit_seconds);
+		}
+		print_phase("write", write_seconds);
+		print_phase("total", total_seconds);
+		std::printf("%-12s %10lu\n", "triangles", (unsigned long)num_triangles);
+		std::printf("%-12s %10lu\n", "degenerate", (unsigned long)stats.num_degenerate_triangles);
+		std::printf("%-12s %10lu\n", "duplicate", (unsigned long)stats.num_duplicate_triangles);
+		std::printf("%-12s %10lu\n", "faces", (unsigned long)mesh->faces.size());
+		if (options.output != OUTPUT_TRIANGLE_LIST) {
+			std::printf("%-12s %10lu\n", "rounds", (unsigned long)stats.num_rounds);
+			std::printf("%-12s %10lu\n", "experiments", (unsigned long)stats.num_experiments);
+			std::printf("%-12s %10lu\n", "aborted", (unsigned long)stats.num_aborted_experiments);
+			std::printf("%-12s %10lu\n", "traversed", (unsigned long)stats.num_traversed_faces);
+			std::printf("%-12s %10lu\n", "probes", (unsigned long)stats.num_adjacency_probes);
+			std::printf("%-12s %10lu\n", "skips", (unsigned long)stats.num_reset_point_skips);
+			print_histogram(stats.strip_length_histogram);
+		}
+		std::printf("%-12s %10lu\n", "strips", (unsigned long)strip_lengths.size());
+		std::printf("%-12s %10lu\n", "indices", (unsigned long)strip_indices.size());
+		std::printf("%-12s %10.3f\n", "per face",
+		            mesh->faces.empty() ? 0.0
+		            : double(strip_indices.size()) / mesh->faces.size());
+		std::printf("%-12s %10lu\n", "degenerates", (unsigned long)cache_stats.num_degenerates);
+		std::printf("%-12s %10lu\n", "restarts", (unsigned long)cache_stats.num_restarts);
+		std::printf("%-12s %10.3f (cache size %d)\n", "acmr", cache_stats.acmr, analysis.cache_size);
+		std::printf("%-12s %10.3f\n", "atvr", cache_stats.atvr);
+	} catch (const std::exception & e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -37,15 +37,150 @@
 #
 # ***** END LICENSE BLOCK *****
 
-from libcpp.list cimport list as list_
+import sys
+
+from libc.stdint cimport uint16_t, uint32_t
+from libc.string cimport memcpy
 from libcpp.deque cimport deque
+from libcpp.list cimport list as list_
+from libcpp.vector cimport vector
+
+# the library keeps no global state, so the GIL is released while
+# stripifying, and other Python threads can stripify at the same time
+cdef extern from "tristrip.hpp" nogil:
+    list_[deque[int]] c_stripify "stripify" (list_[list_[int]] triangles) except +
+    void c_stripify_uint16 "stripify" (
+        const uint16_t *indices, size_t num_triangles,
+        vector[uint16_t] & strip_indices, vector[size_t] & strip_lengths) except +
+    void c_stripify_uint32 "stripify" (
+        const uint32_t *indices, size_t num_triangles,
+        vector[uint32_t] & strip_indices, vector[size_t] & strip_lengths) except +
+    cdef struct BatchMesh:
+        const uint32_t *indices
+        size_t num_triangles
+    cdef cppclass BatchStrips:
+        vector[uint32_t] indices
+        vector[size_t] lengths
+    void c_stripify_batch "stripify_batch" (
+        const vector[BatchMesh] & meshes, vector[BatchStrips] & strips,
+        int num_threads) except +
+
+def _get_index_size(view):
+    """Size of the unsigned integers in a buffer, 2 or 4, or 0 if
+    it does not hold native 16 or 32 bit unsigned integers.
+    """
+    format = view.format
+    if format[:1] in ("@", "="):
+        format = format[1:]
+    elif format[:1] == ("<" if sys.byteorder == "little" else ">"):
+        format = format[1:]
+    if format in ("H", "I", "L") and view.itemsize in (2, 4):
+        return view.itemsize
+    return 0
+
+def _get_index_view(triangles, index_sizes):
+    """Flat memoryview of the indices of a buffer of triangles. The
+    buffer is used as is if it is contiguous, with indices of one of
+    the given sizes, else it is converted to 32 bit indices, as are
+    sequences of triangles.
+    """
+    try:
+        view = memoryview(triangles)
+    except TypeError:
+        # not a buffer, but a sequence of triangles
+        view = triangles
+        index_size = 0
+    else:
+        index_size = _get_index_size(view)
+    if index_size not in index_sizes or not view.c_contiguous:
+        # only here are the triangles copied
+        import numpy
+        view = memoryview(numpy.ascontiguousarray(view, dtype=numpy.uint32))
+        index_size = 4
+    if view.nbytes % (3 * index_size):
+        raise ValueError("number of indices must be a multiple of three")
+    if not view.nbytes:
+        # views with zeros in their shape cannot be cast
+        view = memoryview(b"")
+    return view.cast("B").cast("H" if index_size == 2 else "I")
+
+cdef _get_array_uint16(const vector[uint16_t] & indices):
+    """Copy indices into a numpy array."""
+    import numpy
+    array = numpy.empty(indices.size(), dtype=numpy.uint16)
+    cdef uint16_t[::1] c_array = array
+    if indices.size():
+        memcpy(&c_array[0], indices.data(), 2 * indices.size())
+    return array
+
+cdef _get_array_uint32(const vector[uint32_t] & indices):
+    """Copy indices into a numpy array."""
+    import numpy
+    array = numpy.empty(indices.size(), dtype=numpy.uint32)
+    cdef uint32_t[::1] c_array = array
+    if indices.size():
+        memcpy(&c_array[0], indices.data(), 4 * indices.size())
+    return array
 
-cdef extern from "tristrip.hpp":
-    list_[deque[int]] c_stripify "stripify" (list_[list_[int]] triangles)
+cdef _get_offsets(const vector[size_t] & lengths):
+    """Offsets of strips of given lengths, with a final offset at
+    the end of the last strip.
+    """
+    import numpy
+    offsets = numpy.empty(lengths.size() + 1, dtype=numpy.int64)
+    cdef long long[::1] c_offsets = offsets
+    cdef size_t i
+    c_offsets[0] = 0
+    for i in range(lengths.size()):
+        c_offsets[i + 1] = c_offsets[i] + lengths[i]
+    return offsets
+
+def _stripify_buffer(triangles):
+    """Stripify the triangles of a buffer, see stripify."""
+    view = _get_index_view(triangles, (2, 4))
+    cdef size_t num_triangles = len(view) // 3
+    cdef const uint16_t[::1] c_indices_uint16
+    cdef const uint32_t[::1] c_indices_uint32
+    cdef vector[uint16_t] c_strip_indices_uint16
+    cdef vector[uint32_t] c_strip_indices_uint32
+    cdef vector[size_t] c_strip_lengths
+    if view.itemsize == 2:
+        if num_triangles:
+            c_indices_uint16 = view
+            with nogil:
+                c_stripify_uint16(&c_indices_uint16[0], num_triangles,
+                                  c_strip_indices_uint16, c_strip_lengths)
+        indices = _get_array_uint16(c_strip_indices_uint16)
+    else:
+        if num_triangles:
+            c_indices_uint32 = view
+            with nogil:
+                c_stripify_uint32(&c_indices_uint32[0], num_triangles,
+                                  c_strip_indices_uint32, c_strip_lengths)
+        indices = _get_array_uint32(c_strip_indices_uint32)
+    return indices, _get_offsets(c_strip_lengths)
 
 def stripify(triangles):
-    """Stripify list of triangles."""
+    """Stripify triangles.
+
+    Triangles are either a sequence of vertex index triples, in which
+    case a list of strips is returned, each a list of vertex indices;
+    or an object supporting the buffer protocol, such as an (N, 3)
+    numpy array. Buffers of 16 or 32 bit unsigned integers are
+    stripified in place, without copying; other buffers are first
+    converted to 32 bit. For a buffer, a tuple (indices, offsets) of
+    numpy arrays is returned: the indices of all strips back to back,
+    of the same type as the triangles, and the offset of each strip
+    in indices, followed by the number of indices, so strip i is
+    indices[offsets[i]:offsets[i + 1]].
+    """
 
+    try:
+        memoryview(triangles)
+    except TypeError:
+        pass
+    else:
+        return _stripify_buffer(triangles)
     cdef list_[int] c_triangle
     cdef list_[list_[int]] c_triangles
     cdef deque[int] c_strip
@@ -57,7 +192,8 @@ def stripify(triangles):
             c_triangle.push_back(vertex)
         c_triangles.push_back(c_triangle)
     # stripify
-    c_strips = c_stripify(c_triangles)
+    with nogil:
+        c_strips = c_stripify(c_triangles)
     # convert result back to python list
     strips = []
     while (not c_strips.empty()):
@@ -70,3 +206,39 @@ def stripify(triangles):
         strips.append(strip)
     return strips
 
+
+def stripify_many(meshes, threads=0):
+    """Stripify many meshes at once, on a pool of threads, zero
+    meaning one per core.
+
+    Each mesh is anything stripify takes: a buffer, such as an (N, 3)
+    numpy array, or a sequence of vertex index triples. Contiguous 32
+    bit unsigned indices are used without copying; other meshes are
+    first converted to 32 bit. Returns a list with a tuple (indices,
+    offsets) of numpy arrays for each mesh, in order, as stripify
+    returns for a buffer, except that indices are always 32 bit.
+    """
+
+    views = [_get_index_view(mesh, (4,)) for mesh in meshes]
+    cdef vector[BatchMesh] c_meshes
+    cdef vector[BatchStrips] c_strips
+    cdef BatchMesh c_mesh
+    cdef const uint32_t[::1] c_indices
+    cdef int c_threads = threads
+    cdef size_t i
+    c_meshes.reserve(len(views))
+    for view in views:
+        # views keeps the buffers alive until the batch is done
+        c_mesh.indices = NULL
+        c_mesh.num_triangles = len(view) // 3
+        if c_mesh.num_triangles:
+            c_indices = view
+            c_mesh.indices = &c_indices[0]
+        c_meshes.push_back(c_mesh)
+    with nogil:
+        c_stripify_batch(c_meshes, c_strips, c_threads)
+    strips = []
+    for i in range(c_strips.size()):
+        strips.append((_get_array_uint32(c_strips[i].indices),
+                       _get_offsets(c_strips[i].lengths)))
+    return strips